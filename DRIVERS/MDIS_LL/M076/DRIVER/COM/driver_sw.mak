@@ -21,6 +21,7 @@ MAK_NAME=m76_sw
 MAK_SWITCH=$(SW_PREFIX)MAC_MEM_MAPPED \
 		   $(SW_PREFIX)MAC_BYTESWAP \
 		   $(SW_PREFIX)M76_VARIANT=M76_SW 
+# bus access tracer (M76_BLK_TRC): add $(SW_PREFIX)M76_TRACE
 		   
 		   
 MAK_LIBS=$(LIB_PREFIX)$(MEN_LIB_DIR)/desc$(LIB_SUFFIX)	\
@@ -31,6 +32,7 @@ MAK_LIBS=$(LIB_PREFIX)$(MEN_LIB_DIR)/desc$(LIB_SUFFIX)	\
 
 MAK_INCL=$(MEN_INC_DIR)/m76_drv.h	\
          $(MEN_MOD_DIR)/m76_uee.h	\
+         $(MEN_MOD_DIR)/m76_trc.h	\
          $(MEN_INC_DIR)/men_typs.h	\
          $(MEN_INC_DIR)/oss.h		\
          $(MEN_INC_DIR)/mdis_err.h	\
@@ -45,6 +47,8 @@ MAK_INCL=$(MEN_INC_DIR)/m76_drv.h	\
 
 MAK_INP1=m76_drv$(INP_SUFFIX)
 MAK_INP2=m76_uee$(INP_SUFFIX)
+MAK_INP3=m76_trc$(INP_SUFFIX)
 
 MAK_INP=$(MAK_INP1) \
-        $(MAK_INP2)
+        $(MAK_INP2) \
+        $(MAK_INP3)
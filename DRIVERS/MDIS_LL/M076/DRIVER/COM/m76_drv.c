@@ -16,6 +16,7 @@
  *
  *     Required: OSS, DESC, DBG, ID libraries 
  *     Switches: _ONE_NAMESPACE_PER_DRIVER_
+ *               M76_TRACE   bus access tracer (see m76_trc.c)
  *
  *-------------------------------[ History ]---------------------------------
  *
@@ -71,6 +72,7 @@ static const char RCSid[]="$Id: m76_drv.c,v 1.8 2010/03/11 17:04:34 amorbach Exp
 #include <MEN/ll_defs.h>    /* low-level driver definitions   */
 #include <MEN/microwire.h>  /* ID PROM functions              */
 #include "m76_uee.h"        /* user EEPROM functions          */
+#include "m76_trc.h"        /* bus access tracer              */
 
 /*-----------------------------------------+
 |  DEFINES                                 |
@@ -86,6 +88,32 @@ static const char RCSid[]="$Id: m76_drv.c,v 1.8 2010/03/11 17:04:34 amorbach Exp
 #define UEE_MAGIC           0x3730      /* user EEPROM magic word */
 #define UEE_MAGIC_ADDRESS   0x91        /* address for user EEPROM magic word */
 #define POLL_TOUT           200         /* timeout for polled read access */
+#define JOB_TICK            1           /* asynchronous job alarm period [ms] */
+#define JOB_UEE_TOUT        1000        /* asynchronous uee erase/write timeout [ms] */
+#define JOB_UEE_RETRY       10          /* asynchronous uee write retries */
+#define PACE_TOUT           2000        /* paced read timeout beyond period [ms] */
+#define EVT_NUM             128         /* entries of event ring (M76_EVT_MAX) */
+#define ACQ_BINS            24          /* histogram bins (M76_ACQ_BINS) */
+#define PF_MAX              64          /* post-filter window (M76_PFILT_MAX) */
+#define RANGE_NUM           26          /* number of ranges (M76_RANGE_xxx) */
+#define USER_NUM            6           /* custom presets (M76_RANGE_USER_MAX) */
+#define RANGE_MAX           (RANGE_NUM + USER_NUM)
+#define USER_KEYS           8           /* descriptor keys of custom preset */
+#define USER_SAV_FIL        0x01        /* filter word saved by preset */
+#define USER_SAV_SET        0x02        /* settle time saved by preset */
+
+#define RANGE_IS_R(r)       (((r) >= M76_RANGE_R2_0) && ((r) <= M76_RANGE_R4_4))
+#define CALI_DIRTY(r)       (((r) < RANGE_NUM) ? (1 << (r)) : 0)  /* stored */
+
+/* event trace/statistics timestamp, may be replaced by a cycle counter */
+#ifndef M76_EVT_TIME
+# define M76_EVT_TIME(h)    ((u_int32)OSS_TickGet((h)->osHdl))
+# define M76_EVT_RATE(h)    ((u_int32)OSS_TickRateGet((h)->osHdl))
+#endif
+
+/* put event into event ring */
+#define EVT(h,id,a0,a1) \
+    do { if ((h)->evtOn) EvtPut((h),(id),(u_int32)(a0),(u_int32)(a1)); } while(0)
 
 /* debug settings */
 #define DBG_MYLEVEL         llHdl->dbgLevel 
@@ -136,6 +164,7 @@ static const char RCSid[]="$Id: m76_drv.c,v 1.8 2010/03/11 17:04:34 amorbach Exp
 #define MOD_NORMAL      (0<<5)          /* normal measurement mode */
 #define MOD_ZERO        (2<<5)          /* zero-scale system calibration */
 #define MOD_FULL        (3<<5)          /* full-scale system calibration */
+#define MOD_ZERO_SELF   (6<<5)          /* zero-scale self-calibration */
 /* gain (G0, G1, G2) */
 #define MOD_GAIN_1      (0<<2)          /* gain = 1 */
 #define MOD_GAIN_4      (2<<2)          /* gain = 4 */
@@ -143,7 +172,18 @@ static const char RCSid[]="$Id: m76_drv.c,v 1.8 2010/03/11 17:04:34 amorbach Exp
 /* ADC's Filter High Register */
 #define FHI_POLAR_BI    (0<<7)          /* bipolar measurement */
 #define FHI_POLAR_UNI   (1<<7)          /* unipolar measurement */
-#define FHI_WL          (1<<6)          /* 24-bit word length */
+#define FHI_WL          (1<<6)          /* 24-bit word length (else 16-bit) */
+
+/* ADC filter timing: conversion time = filter word * FIL_CLKDIV / FIL_FCLK,
+   the sinc^3 filter settles within FIL_SETTLE conversions */
+#define FIL_FCLK        2457600         /* ADC master clock [Hz] */
+#define FIL_CLKDIV      128
+#define FIL_SETTLE      3
+#define FIL_MIN         20              /* filter word range */
+#define FIL_MAX         1920
+
+/* noise-adaptive filter (M76_ADAPT) */
+#define ADAPT_LD        4               /* ld of differences per estimate */
 
 /* measurement ranges (Configuration Register) */
 #define DC_V0   0x06fae600  /* DC voltage range 125mV */
@@ -178,6 +218,24 @@ static const char RCSid[]="$Id: m76_drv.c,v 1.8 2010/03/11 17:04:34 amorbach Exp
 #define R4_3    0x43f9ed00  /* resistance, 4-wire, 250 kOhm */
 #define R4_4    0x43f9f500  /* resistance, 4-wire, 2,5 MOhm   */
 
+/* steps of asynchronous calibration job */
+#define JS_CALI_CHAN        0           /* select Im channel */
+#define JS_CALI_SETTLE      1           /* settle after channel change */
+#define JS_CALI_START       2           /* initiate calibration */
+#define JS_CALI_DATA        3           /* read Data Register */
+#define JS_CALI_DATA_WAIT   4           /* wait for TRDYR */
+#define JS_CALI_REG_WAIT    5           /* wait for TRDYR (Calibration Register) */
+#define JS_CALI_RESTORE     6           /* restore Ux channel */
+#define JS_CALI_SETTLE2     7           /* settle after channel change */
+#define JS_CALI_NUM         8
+
+/* steps of asynchronous store job */
+#define JS_STORE_START      0           /* select user EEPROM */
+#define JS_STORE_SAVE       1           /* read previous word */
+#define JS_STORE_ERASE      2           /* start erasing word */
+#define JS_STORE_ERASE_WAIT 3           /* wait for erase cycle */
+#define JS_STORE_WRITE_WAIT 4           /* wait for write cycle, verify */
+
 /* ... */
 
 /*-----------------------------------------+
@@ -206,7 +264,54 @@ typedef struct  {
 
 #define CALI_SIZE       sizeof(CALI_VALS)
 
+typedef struct {    /* custom range preset (M76_RANGE_DEF) */
+    u_int32     defined;
+    u_int32     config;     /* Config. Reg. */
+    u_int16     comChan;    /* ADC channel */
+    u_int16     modGain;    /* gain (Mode Reg.) */
+    u_int16     polarity;   /* FHI_POLAR_xxx */
+    u_int16     filter;     /* filter word (0=unchanged) */
+    u_int32     settle;     /* settling time (0=unchanged) */
+    CALI_VA     cali;       /* own calibration values */
+} USER_RANGE;
+
+/* event trace (see M76_EVT) */
+typedef struct {
+    u_int32     time;       /* timestamp */
+    u_int32     id;         /* M76_EV_xxx */
+    u_int32     arg[2];     /* arguments */
+} EVT_ENTRY;
+
+/* acquisition statistics (see M76_ACQ_STAT) */
+typedef struct {
+    u_int32     reads;              /* conversions read */
+    u_int32     semTout;            /* interrupt wait errors */
+    u_int32     pollTout;           /* poll timeouts */
+    u_int32     irqs;               /* device interrupts */
+    u_int32     settles;            /* settle delays */
+    u_int32     settleMs;           /* total settle time [ms] */
+    u_int32     convLat[ACQ_BINS];  /* TR24R armed to data read */
+    u_int32     irqWake[ACQ_BINS];  /* interrupt to reader woken */
+    u_int32     settle[ACQ_BINS];   /* settle delay */
+} ACQ_STAT;
+
+
 
+/* streaming statistics (see M76_STAT_SET) */
+typedef struct {
+    u_int32     count;      /* conversions */
+    int32       min;        /* min. raw code */
+    int32       max;        /* max. raw code */
+    int64       mean;       /* mean * 2^M76_STAT_Q */
+    u_int64     m2;         /* sum of squared deviations * 2^M76_STAT_Q */
+} STAT_SET;
+
+/* record of paced sampling (see M76_PACE_REC) */
+typedef struct {
+    int32       value;      /* raw code */
+    u_int32     seq;        /* alarm period number */
+    u_int32     time;       /* time since start [ms] */
+} PACE_REC;
 
 /* low-level handle */
 typedef struct {
@@ -238,6 +343,135 @@ typedef struct {
     u_int32         calibOk;        /* actual range calibrated */
     u_int32         settleTime;     /* settle time after changing range/ADC channel */
     CALI_VALS       caliVals;       /* calibration memory */
+    u_int32         caliPolicy;     /* calibration source policy */
+    u_int32         mainsHz;        /* mains frequency (M76_PLC) */
+    u_int32         caliSrc;        /* source of calibration memory */
+    u_int32         caliDirty;      /* ranges changed since init/store (bits) */
+    USER_RANGE      user[USER_NUM]; /* custom range presets */
+    u_int32         userSaved;      /* values saved by preset (USER_SAV_xxx) */
+    u_int16         userFilter;     /* filter before preset */
+    u_int32         userSettle;     /* settle time before preset */
+    /* asynchronous job */
+    u_int32         async;          /* M76_CALI/M76_STORE_CALI asynchronous */
+    OSS_ALARM_HANDLE *jobAlarm;     /* alarm driving the job */
+    u_int32         jobTick;        /* real alarm period [ms] */
+    volatile u_int32 jobState;      /* M76_JOB_xxx */
+    volatile u_int32 jobCancel;     /* cancel requested */
+    u_int32         jobType;        /* M76_JOBTYPE_xxx */
+    u_int32         jobStep;        /* JS_xxx */
+    u_int32         jobCnt;         /* elapsed time in step [ms] */
+    u_int32         jobIdx;         /* uee word index */
+    u_int32         jobRetry;       /* uee write retries left */
+    int32           jobKind;        /* calibration kind */
+    int32           jobValue;       /* detected calibration value */
+    int32           jobError;       /* error code */
+    u_int16         jobGain;        /* saved Ux gain */
+    u_int16         jobCheckSum;    /* checksum to store */
+    u_int32         jobRestore;     /* canceled store, write back jobOld */
+    u_int32         jobLast;        /* last word to write back */
+    u_int16         jobOld[CALI_SIZE/2+1];  /* previous uee words */
+    /* event trace */
+    u_int32         evtOn;          /* event trace enabled */
+    u_int32         evtCnt;         /* events since init/clear */
+    EVT_ENTRY       evt[EVT_NUM];   /* ring, next at evt[evtCnt % EVT_NUM] */
+    /* acquisition statistics */
+    ACQ_STAT        acq;            /* counters and histograms */
+    u_int32         convStart;      /* time transfer was armed */
+    int32           xferReg;        /* ADC register of armed transfer */
+    u_int32         irqTime;        /* time of last interrupt */
+    /* post-filter */
+    u_int32         pfType;         /* M76_PFILT_xxx */
+    u_int32         pfN;            /* window length/IIR shift */
+    u_int32         pfCnt;          /* samples in window (0=restart) */
+    u_int32         pfIdx;          /* next window entry */
+    u_int32         pfSum;          /* sum of window/N (BOX) */
+    u_int32         pfRem;          /* sum of window%N (BOX) */
+    u_int64         pfAcc;          /* y * 2^pfN (IIR) */
+    int32           pfWin[PF_MAX];  /* window of samples */
+    /* oversampling */
+    u_int8          ovsK[RANGE_MAX];/* 2^k conversions per sample */
+    u_int32         ovsFrac;        /* fraction bits of sample */
+    u_int32         ovsRnd;         /* round to nearest */
+    /* streaming statistics */
+    u_int32         statOn;         /* statistics enabled */
+    u_int32         statWin;        /* window length (0=endless) */
+    u_int32         statWins;       /* completed windows */
+    STAT_SET        statCur;        /* running window */
+    STAT_SET        statLast;       /* last completed window */
+    /* envelope */
+    u_int32         envN;           /* conversions per record (0=off) */
+    /* dead-band */
+    u_int32         dbAbs;          /* absolute dead-band [codes] */
+    u_int32         dbRel;          /* relative dead-band [ppm] */
+    u_int32         dbHeart;        /* heartbeat [ms] */
+    u_int32         dbHeartTicks;   /* heartbeat [ticks] */
+    u_int32         dbValid;        /* dbLast valid */
+    int32           dbLast;         /* last reported value */
+    u_int32         dbBand;         /* dead-band around dbLast */
+    u_int32         dbTime;         /* time of last report */
+    /* trigger */
+    u_int32         trgMode;        /* M76_TRG_xxx */
+    int32           trgLevel;       /* level/window low */
+    int32           trgLevel2;      /* window high */
+    u_int32         trgPre;         /* pre-trigger samples */
+    u_int32         trgPost;        /* post-trigger samples */
+    u_int32         trgTout;        /* timeout [ms] */
+    u_int32         trgToutTicks;   /* timeout [ticks] */
+    /* limit alarms */
+    u_int32         almOn;          /* limits checked */
+    int32           almHigh;        /* high limit */
+    int32           almLow;         /* low limit */
+    u_int32         almHyst;        /* hysteresis */
+    u_int32         almState;       /* M76_ALM_xxx */
+    OSS_SIG_HANDLE  *almSig;        /* signal on violation */
+    /* non-blocking read */
+    u_int32         nbOn;           /* M76_NBLOCK_xxx */
+    u_int16         nbPending;      /* access bits of armed transfer (0=none) */
+    OSS_SIG_HANDLE  *rdySig;        /* signal on data ready */
+    volatile int32   ltValue;       /* latest conversion */
+    volatile u_int32 ltSeq;         /* conversions fetched */
+    volatile u_int32 ltTime;        /* time of latest conversion */
+    volatile u_int32 ltValid;       /* ltValue of current setup */
+    volatile u_int32 ltNew;         /* ltValue not yet in statistics/alarm */
+    /* paced sampling */
+    u_int32         pacePeriod;     /* alarm period [ms] (0=off) */
+    u_int32         paceSize;       /* queue size [records] */
+    u_int32         paceWmark;      /* watermark [records] */
+    OSS_ALARM_HANDLE *paceAlarm;    /* alarm pacing the conversions */
+    PACE_REC        *paceBuf;       /* record queue */
+    u_int32         paceAlloc;      /* size allocated for the queue */
+    volatile u_int32 pacePut;       /* write index (modulo 2*paceSize) */
+    volatile u_int32 paceGet;       /* read index (modulo 2*paceSize) */
+    u_int32         paceSeq;        /* alarm periods */
+    u_int32         paceStart;      /* time of start */
+    u_int32         paceLost;       /* records lost, queue full */
+    u_int32         paceLate;       /* periods without conversion */
+    /* sample format */
+    u_int32         fmt;            /* M76_FMT_xxx */
+    u_int32         fast;           /* 16-bit data word */
+    /* noise-adaptive filter */
+    u_int32         adaptTarget;    /* target noise rms [LSB] (0=off) */
+    u_int32         adaptCnt;       /* conversions of current estimate */
+    int32           adaptLast;      /* previous conversion */
+    u_int64         adaptSum;       /* sum of squared differences */
+    u_int32         adaptNoise;     /* last estimate, rms [LSB] */
+    u_int16         adaptReq;       /* filter word to set (0=none) */
+    /* background zero-scale self-calibration */
+    u_int32         zcalMode;       /* M76_ZCAL_xxx */
+    u_int32         zcalPeriod;     /* period [ms] */
+    u_int32         zcalTicks;      /* period [ticks] */
+    u_int32         zcalTime;       /* time of latest self-calibration */
+    u_int32         zcalValid;      /* zcalBase valid */
+    u_int32         zcalFlag;       /* last value read after it */
+    u_int32         zcalSlots;      /* self-calibrations done */
+    int32           zcalBase;       /* first after range/filter set */
+    int32           zcalLast;       /* latest */
+    int32           zcalApplied;    /* zero-scale value written to ADC */
+#ifdef M76_TRACE
+    /* bus access trace */
+    struct m76_trc  *trc;           /* counters and register access log */
+    u_int32         trcAlloc;       /* size allocated for the trace */
+#endif
 
     MCRW_HANDLE    *mcrwHdl;        /* microwire handle for IDPROM */
 } LL_HANDLE;
@@ -246,6 +480,13 @@ typedef struct {
 #include <MEN/ll_entry.h>   /* low-level driver branch table  */
 #include <MEN/m76_drv.h>    /* M76 driver header file */
 
+/* internal sizes of LL_HANDLE must match m76_drv.h (compile error if not) */
+typedef char ChkEvtNum[(EVT_NUM == M76_EVT_MAX) ? 1 : -1];
+typedef char ChkAcqBins[(ACQ_BINS == M76_ACQ_BINS) ? 1 : -1];
+typedef char ChkPfMax[(PF_MAX == M76_PFILT_MAX) ? 1 : -1];
+typedef char ChkRangeNum[(RANGE_NUM == M76_RANGE_USER(0)) ? 1 : -1];
+typedef char ChkUserNum[(USER_NUM == M76_RANGE_USER_MAX) ? 1 : -1];
+
 /*-----------------------------------------+
 |  PROTOTYPES                              |
 +-----------------------------------------*/
@@ -269,17 +510,86 @@ static int32 Cleanup(LL_HANDLE *llHdl, int32 retCode);
 
 static int32 MakeMwHandle( LL_HANDLE *llHdl );
 
+static int32 LoadCaliVals(LL_HANDLE *llHdl);
 static int32 ReadCaliProm(LL_HANDLE *llHdl);
+static int32 CheckCaliBlob(u_int8 *blob);
+static u_int32 CaliBlobToMem(LL_HANDLE *llHdl, u_int8 *blob);
+static int32 CmpCaliBlob(LL_HANDLE *llHdl, u_int8 *blob);
+static void  CaliMemToBlob(LL_HANDLE *llHdl, u_int8 *blob);
+static u_int16 CaliChecksum(int32 *vals);
 static int32 WriteCaliProm(LL_HANDLE *llHdl);
 static int32 WriteCaliReg(LL_HANDLE *llHdl);
 static int32 WriteCaliRegUpd(LL_HANDLE *llHdl);
 static int32 CalibAdc(LL_HANDLE *llHandle, int32 *value);
+static int32 CheckCaliKind(u_int32 range, int32 kind);
+static int32 CalibConv(LL_HANDLE *llHdl, u_int16 mode, int32 reg, int32 *val);
+static int32 CalibJob(LL_HANDLE *llHdl, M76_CALI_JOB *job);
+static int32 SetRange(LL_HANDLE *llHdl, int32 range);
 static int32 WriteConfigReg(LL_HANDLE *llHdl);
 static int32 WriteModeReg(LL_HANDLE *llHdl);
 static int32 WriteFilterReg(LL_HANDLE *llHdl);
 static int32 ReadDataReg(LL_HANDLE *llHdl, int32 *value, int32 reg);
+static void  StartDataReg(LL_HANDLE *llHdl, int32 reg, u_int16 acc);
+static int32 GetDataReg(LL_HANDLE *llHdl);
+static int32 JobStart(LL_HANDLE *llHdl, u_int32 type, int32 kind);
+static void  JobAlarm(void *arg);
+static void  JobCaliStep(LL_HANDLE *llHdl);
+static void  JobStoreStep(LL_HANDLE *llHdl);
+static void  JobEnd(LL_HANDLE *llHdl, int32 error);
 static int32 WriteCaliVal(LL_HANDLE *llHdl, u_int32 mode, u_int32 val);
 static int32 UeeWrite(LL_HANDLE *llHdl, u_int8 index, u_int16 value);
+static void  EvtPut(LL_HANDLE *llHdl, u_int32 id, u_int32 arg0, u_int32 arg1);
+static void  Settle(LL_HANDLE *llHdl);
+static void  HistAdd(u_int32 *hist, u_int32 t);
+static int32 ReadConv(LL_HANDLE *llHdl, int32 *valueP);
+static int32 ReadSample(LL_HANDLE *llHdl, int32 *valueP);
+static int32 PostFilter(LL_HANDLE *llHdl, int32 *valueP);
+static void  StatAdd(LL_HANDLE *llHdl, int32 x);
+static u_int64 Div64(u_int64 a, u_int32 b);
+static void  StatCopy(M76_STAT_SET *dst, STAT_SET *src);
+static int32 EnvRead(LL_HANDLE *llHdl, M76_ENV *env, int32 size,
+                     int32 *nbrRdBytesP);
+static int32 DeadBand(LL_HANDLE *llHdl, int32 value);
+static int32 TrgRead(LL_HANDLE *llHdl, M76_TRG_REC *rec, int32 size,
+                     int32 *nbrRdBytesP);
+static void  Reverse(int32 *p, u_int32 n);
+static void  AlmCheck(LL_HANDLE *llHdl, int32 x);
+static u_int32 MsToTicks(LL_HANDLE *llHdl, u_int32 ms);
+static int32 NbRead(LL_HANDLE *llHdl, int32 *valueP);
+static void  NbStart(LL_HANDLE *llHdl);
+static void  NbCancel(LL_HANDLE *llHdl);
+static void  NbFetch(LL_HANDLE *llHdl);
+static u_int32 TicksToMs(LL_HANDLE *llHdl, u_int32 t);
+static int32 PaceStart(LL_HANDLE *llHdl, u_int32 period);
+static void  PaceStop(LL_HANDLE *llHdl);
+static void  PaceAlarm(void *arg);
+static int32 PaceRead(LL_HANDLE *llHdl, M76_PACE_REC *rec, int32 size,
+                      int32 *nbrRdBytesP);
+static u_int32 FmtStatus(LL_HANDLE *llHdl, int32 x);
+static u_int32 FmtWords(LL_HANDLE *llHdl, int32 *p, u_int32 n);
+static u_int32 FilterPlc(LL_HANDLE *llHdl);
+static void  AdaptAdd(LL_HANDLE *llHdl, int32 x);
+static void  AdaptApply(LL_HANDLE *llHdl);
+static u_int32 Sqrt64(u_int64 x);
+static int32 ZcalSlot(LL_HANDLE *llHdl);
+static CALI_VA *CaliVa(LL_HANDLE *llHdl);
+static int32 UserRangeDef(LL_HANDLE *llHdl, M76_RANGE_DEF *def);
+static int32 UserRangeDesc(LL_HANDLE *llHdl, u_int32 n);
+#ifdef M76_TRACE
+static int32 TrcInit(DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
+                     MACCESS *ma, OSS_SEM_HANDLE *devSemHdl,
+                     OSS_IRQ_HANDLE *irqHdl, LL_HANDLE **llHdlP);
+static int32 TrcExit(LL_HANDLE **llHdlP);
+static int32 TrcRead(LL_HANDLE *llHdl, int32 ch, int32 *value);
+static int32 TrcWrite(LL_HANDLE *llHdl, int32 ch, int32 value);
+static int32 TrcSetStat(LL_HANDLE *llHdl, int32 code, int32 ch, INT32_OR_64 value32_or_64);
+static int32 TrcGetStat(LL_HANDLE *llHdl, int32 code, int32 ch, INT32_OR_64 *value32_or_64P);
+static int32 TrcBlockRead(LL_HANDLE *llHdl, int32 ch, void *buf, int32 size,
+                          int32 *nbrRdBytesP);
+static int32 TrcBlockWrite(LL_HANDLE *llHdl, int32 ch, void *buf, int32 size,
+                           int32 *nbrWrBytesP);
+static int32 TrcIrq(LL_HANDLE *llHdl);
+#endif
 
 /**************************** M76_GetEntry *********************************
  *
@@ -306,6 +616,19 @@ static int32 UeeWrite(LL_HANDLE *llHdl, u_int8 index, u_int16 value);
     drvP->getStat     = M76_GetStat;
     drvP->irq         = M76_Irq;
     drvP->info        = M76_Info;
+
+#ifdef M76_TRACE
+    /* trace all entry points */
+    drvP->init        = TrcInit;
+    drvP->exit        = TrcExit;
+    drvP->read        = TrcRead;
+    drvP->write       = TrcWrite;
+    drvP->blockRead   = TrcBlockRead;
+    drvP->blockWrite  = TrcBlockWrite;
+    drvP->setStat     = TrcSetStat;
+    drvP->getStat     = TrcGetStat;
+    drvP->irq         = TrcIrq;
+#endif
 }
 
 /******************************** M76_Init ***********************************
@@ -324,6 +647,36 @@ static int32 UeeWrite(LL_HANDLE *llHdl, u_int8 index, u_int16 value);
  *                DEBUG_LEVEL_DESC      OSS_DBG_DEFAULT  see dbg.h
  *                DEBUG_LEVEL           OSS_DBG_DEFAULT  see dbg.h
  *                ID_CHECK              1                0..1
+ *                CALI_POLICY           0                0..2
+ *                CALI_BLOB             -                296 bytes
+ *                MAINS_FREQ            50               50, 60
+ *                RANGE_USER_<n>/CONFIG -                0..0xffffffff
+ *                RANGE_USER_<n>/CHAN   4                0..7
+ *                RANGE_USER_<n>/GAIN   0                0..7
+ *                RANGE_USER_<n>/UNIPOLAR 0              0..1
+ *                RANGE_USER_<n>/FILTER 0                0, 20..1920
+ *                RANGE_USER_<n>/SETTLE 0                0..max
+ *                RANGE_USER_<n>/CALI_ZERO 0xffffffff    0..0xffffffff
+ *                RANGE_USER_<n>/CALI_FULL 0xffffffff    0..0xffffffff
+ *
+ *                CALI_POLICY selects the source of the calibration memory:
+ *                  0 = M76_CALI_POL_EEPROM   read user EEPROM only
+ *                  1 = M76_CALI_POL_BLOB     use CALI_BLOB if its checksum
+ *                                            is valid, else read user EEPROM
+ *                  2 = M76_CALI_POL_COMPARE  read user EEPROM and CALI_BLOB,
+ *                                            CALI_BLOB is used if they differ
+ *
+ *                CALI_BLOB is a complete calibration memory image in the
+ *                format of M76_BLK_CALI_BLOB (see M76_SetStat).
+ *
+ *                MAINS_FREQ is the mains frequency [Hz] the filter presets
+ *                of M76_PLC reject (see M76_SetStat).
+ *
+ *                RANGE_USER_<n> (n=0..M76_RANGE_USER_MAX-1) defines the
+ *                custom range preset M76_RANGE_USER(n), see M76_RANGE_DEF
+ *                for the meaning of the keys. A preset is defined if its
+ *                CONFIG key exists. 0xffffffff calibration values mean 
+ *                not calibrated.
  *---------------------------------------------------------------------------
  *  Input......:  descSpec   pointer to descriptor data
  *                osHdl      oss handle
@@ -366,6 +719,7 @@ static int32 M76_Init(
     llHdl->osHdl      = osHdl;
     llHdl->irqHdl     = irqHdl;
     llHdl->ma         = *ma;
+    llHdl->evtOn      = TRUE;
 
     /*--- create handle for Microwire lib ---*/
     if( (error = MakeMwHandle( llHdl )))
@@ -418,6 +772,29 @@ static int32 M76_Init(
         error != ERR_DESC_KEY_NOTFOUND)
         return( Cleanup(llHdl,error) );
 
+    /* CALI_POLICY */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, M76_CALI_POL_EEPROM, 
+                                &llHdl->caliPolicy, "CALI_POLICY")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if (llHdl->caliPolicy > M76_CALI_POL_COMPARE)
+        return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* MAINS_FREQ */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 50, 
+                                &llHdl->mainsHz, "MAINS_FREQ")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ((llHdl->mainsHz != 50) && (llHdl->mainsHz != 60))
+        return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* RANGE_USER_<n> */
+    for (value=0; value<USER_NUM; value++)
+        if ((error = UserRangeDesc(llHdl, value)))
+            return( Cleanup(llHdl,error) );
+
     /*------------------------------+
     |  clr reset                    |
     +------------------------------*/
@@ -461,60 +838,40 @@ static int32 M76_Init(
     /*------------------------------+
     |  init hardware                |
     +------------------------------*/
-    /* check magic word of user EEPROM */
-    /* if there is no magic word in user EEPROM then set all cells used for */
-    /* calibration values to 0xffff */
-    MWRITE_D16(llHdl->ma, CTRL_REG, UEPROM_SEL);    /* select user EEPROM */
-    if ( __M76_UeeRead(llHdl->osHdl, llHdl->ma,
-             (u_int8)UEE_MAGIC_ADDRESS) != UEE_MAGIC )  
-    {
-        u_int16 idx;
-    
-        DBGWRT_2((DBH, " No UEE_MAGIC -> Set all uee calibration cells to 0xffff\n"));
-
-        for (idx=0; idx < (sizeof(llHdl->caliVals)/2+1); idx++)  {
-            error = UeeWrite(llHdl,(u_int8)idx, 0xffff);
-            if (error)  {
-                break;
-            }
-        }
-        /* write MAGIC */
-        if (error == 0)  {
-            error = UeeWrite(llHdl,(u_int8)UEE_MAGIC_ADDRESS,(u_int16)UEE_MAGIC);
-        }
-    }   
-    MWRITE_D16(llHdl->ma, CTRL_REG, IDPROM_SEL);    /* deselect user EEPROM */
-    if (error)      /* error deleting uee */
+    /* load calibration memory (user EEPROM and/or CALI_BLOB) */
+    if ( (error = LoadCaliVals(llHdl)) )
         return( Cleanup(llHdl,error) );
     
-    /* read calibration EEPROM */
-    if ( (error = ReadCaliProm(llHdl)) )  {
-        /* invalid checksum */
-        llHdl->checkSum = FALSE;    
-        llHdl->permitMeas = FALSE;
-    }
-    else  {
-        /* valid checksum */
-        llHdl->checkSum = TRUE;
-        llHdl->permitMeas = TRUE;
-    }
-    
     /* default */
     llHdl->range = M76_RANGE_AC_V3;
     llHdl->conMode = AC_V3; 
     llHdl->comChan = COM_AC;
     llHdl->modGain = MOD_GAIN_1;
     llHdl->modMode = MOD_NORMAL;
-    llHdl->filFilter =  1920;           /* 10Hz */
+    llHdl->filFilter =  FIL_MAX;        /* 10Hz, 5/6 mains cycles */
     llHdl->filPolarity = FHI_POLAR_UNI;
     llHdl->settleTime = 700;            
+    llHdl->pfN = 8;
+    llHdl->ovsRnd = TRUE;
+    llHdl->dbHeart = 1000;
+    llHdl->dbHeartTicks = MsToTicks(llHdl, llHdl->dbHeart);
+    llHdl->trgLevel = 0x800000;
+    llHdl->trgLevel2 = 0xffffff;
+    llHdl->trgPost = 1;
+    llHdl->trgTout = 10000;
+    llHdl->trgToutTicks = MsToTicks(llHdl, llHdl->trgTout);
+    llHdl->almHigh = 0xffffff;
+    llHdl->paceSize = 256;
+    llHdl->paceWmark = 1;
+    llHdl->zcalPeriod = 60000;
+    llHdl->zcalTicks = MsToTicks(llHdl, llHdl->zcalPeriod);
 
     WriteConfigReg(llHdl);
     WriteFilterReg(llHdl);
     WriteModeReg(llHdl);
     WriteCaliRegUpd(llHdl);/* write new cali val to ADC,*/
                            /*  update cali info */
-    OSS_Delay(llHdl->osHdl, llHdl->settleTime);
+    Settle(llHdl);
 
     *llHdlP = llHdl;    /* set low-level driver handle */
 
@@ -539,6 +896,20 @@ static int32 M76_Exit(
 
     DBGWRT_1((DBH, "LL - M76_Exit\n"));
 
+    /*------------------------------+
+    |  stop asynchronous job        |
+    +------------------------------*/
+    if (llHdl->jobAlarm)
+        OSS_AlarmClear(llHdl->osHdl, llHdl->jobAlarm);
+    if (llHdl->pacePeriod)
+        PaceStop(llHdl);
+
+    if ((llHdl->jobState == M76_JOB_BUSY) &&
+        (llHdl->jobType == M76_JOBTYPE_STORE))  {
+        __M76_UeeFinish(llHdl->osHdl, llHdl->ma);
+        MWRITE_D16(llHdl->ma, CTRL_REG, IDPROM_SEL);    /* deselect user EEPROM */
+    }
+
     /*------------------------------+
     |  de-init hardware             |
     +------------------------------*/
@@ -562,6 +933,34 @@ static int32 M76_Exit(
  *                right-aligned in a 32-bit long word. The upper 8 bits are
  *                always zero.
  *
+ *                With oversampling (M76_OVS) the mean of 2^k conversions is
+ *                returned. With M76_OVS_FRAC the value has additional
+ *                fraction bits, i.e. it is scaled by 2^M76_OVS_FRAC.
+ *
+ *                With a dead-band (M76_DB_ABS/M76_DB_REL) the read blocks
+ *                until a value leaves the dead-band around the last 
+ *                returned value or the heartbeat (M76_DB_HEART) expires.
+ *
+ *                In non-blocking mode (M76_NBLOCK) the read returns a 
+ *                raw code or M76_ERR_NODATA at once. M76_NBLOCK_NEXT
+ *                returns each conversion once and starts the next one,
+ *                M76_NBLOCK_LATEST returns the latest conversion of the 
+ *                continuous acquisition (again until a newer one is 
+ *                ready). Oversampling, post-filter and dead-band are not
+ *                applied.
+ *
+ *                With M76_FORMAT = M76_FMT_STATUS the upper byte holds
+ *                the status of the value (M76_FMT_xxx, see m76_drv.h).
+ *
+ *                In 16-bit fast mode (M76_FAST) the value is the 16-bit
+ *                code scaled to 24 bits, i.e. the lower 8 bits are zero.
+ *
+ *                A filter step of the noise-adaptive filter (M76_ADAPT)
+ *                is done after the value was read and settles. A due
+ *                background self-calibration (M76_ZCAL) is done before
+ *                the conversion, the M76_ZCAL_FLAG getstat marks the 
+ *                value then.
+ *
  *                If the checksum test result is FALSE, an error is returned 
  *                as long as read is not explicitly allowed.
  *                If there are no valid calibration values for the selected 
@@ -583,17 +982,41 @@ static int32 M76_Read(
 
     DBGWRT_1((DBH, "LL - M76_Read: ch=%d\n",ch));
 
-    if (llHdl->range > M76_RANGE_AC_A2)     /* wrong range */
+    if (llHdl->jobState == M76_JOB_BUSY)    /* asynchronous job running */
+        return(ERR_LL_DEV_BUSY);
+    if (llHdl->pacePeriod)                  /* paced sampling running */
+        return(ERR_LL_DEV_BUSY);
+    if (RANGE_IS_R(llHdl->range))           /* wrong range */
         return(ERR_LL_ILL_PARAM);
     if (llHdl->permitMeas == FALSE)     /* wrong checksum */
         return(ERR_LL_DEV_NOTRDY);
     if (llHdl->calibOk == FALSE)        /* not calibrated */
         return(ERR_LL_DEV_NOTRDY);
 
-    error = ReadDataReg(llHdl, valueP, COM_DATA);
+    llHdl->zcalFlag = FALSE;
 
-    *valueP >>= 8;
-    *valueP &= 0x00ffffff;
+    if (llHdl->nbOn)
+        error = NbRead(llHdl, valueP);
+    else  {
+        if (llHdl->zcalMode &&
+            (!llHdl->zcalValid ||
+             (M76_EVT_TIME(llHdl) - llHdl->zcalTime >= llHdl->zcalTicks)))
+            error = ZcalSlot(llHdl);
+
+        if (!error) do {
+            if (llHdl->pfType == M76_PFILT_NONE)
+                error = ReadSample(llHdl, valueP);
+            else
+                error = PostFilter(llHdl, valueP);
+        } while (!error && (llHdl->dbAbs || llHdl->dbRel) && 
+                 !DeadBand(llHdl, *valueP));
+    }
+
+    if (!error && llHdl->adaptReq)
+        AdaptApply(llHdl);
+
+    if (!error && (llHdl->fmt == M76_FMT_STATUS))
+        *valueP |= FmtStatus(llHdl, *valueP);
 
     return (error);
 
@@ -636,10 +1059,64 @@ static int32 M76_Write(
  *                M76_SETTLE           settling time               0..max ms
  *                M76_PERMIT           permit measurement if       0..1
  *                                     checksum is wrong    
+ *                M76_ASYNC            asynchronous M76_CALI and   0..1
+ *                                     M76_STORE_CALI
+ *                M76_JOB_CANCEL       cancel asynchronous job     -
+ *                M76_EVT_ON           event trace on/off          0..1
+ *                M76_EVT_CLEAR        clear event trace           -
+ *                M76_ACQ_CLEAR        clear acquisition statist.  -
+ *                M76_PFILT            post-filter type            M76_PFILT_xxx
+ *                M76_PFILT_N          post-filter length          1..64
+ *                                     IIR shift                   1..8
+ *                M76_OVS              oversampling 2^k            0..8
+ *                                     (current range)
+ *                M76_OVS_FRAC         fraction bits of value      0..7
+ *                M76_OVS_RND          round/truncate              0..1
+ *                M76_STAT_ON          streaming statistics on/off 0..1
+ *                M76_STAT_WIN         statistics window length    0..1024
+ *                M76_STAT_CLEAR       clear streaming statistics  -
+ *                M76_ENV_N            conversions per envelope    0..max
+ *                                     record (0=off)
+ *                M76_DB_ABS           dead-band [codes] (0=off)   0..max
+ *                M76_DB_REL           dead-band [ppm] (0=off)     0..1000000
+ *                M76_DB_HEART         dead-band heartbeat [ms]    1..max
+ *                M76_TRG_MODE         trigger mode                M76_TRG_xxx
+ *                M76_TRG_LEVEL        trigger level/window low    0..0xffffff
+ *                M76_TRG_LEVEL2       trigger window high         0..0xffffff
+ *                M76_TRG_PRE          pre-trigger samples         0..65536
+ *                M76_TRG_POST         post-trigger samples        1..65536
+ *                M76_TRG_TOUT         trigger timeout [ms]        1..max
+ *                M76_ALM_ON           limit alarms on/off         0..1
+ *                M76_ALM_HIGH         high alarm limit            0..0xffffff
+ *                M76_ALM_LOW          low alarm limit             0..0xffffff
+ *                M76_ALM_HYST         alarm hysteresis            0..0xffffff
+ *                M76_ALM_STATE        clear latched alarms        M76_ALM_HI/LO
+ *                M76_SIG_SET          install alarm signal        signal code
+ *                M76_SIG_CLR          remove alarm signal         -
+ *                M76_NBLOCK           non-blocking read mode      M76_NBLOCK_xxx
+ *                M76_RDY_SIG_SET      install data ready signal   signal code
+ *                M76_RDY_SIG_CLR      remove data ready signal    -
+ *                M76_PACE_PERIOD      paced sampling period [ms]  0..max
+ *                                     (0=off)
+ *                M76_PACE_SIZE        paced sampling queue size   1..65536
+ *                M76_PACE_WMARK       paced sampling watermark    1..size
+ *                M76_FORMAT           sample format               M76_FMT_xxx
+ *                M76_FAST             16-bit fast mode on/off     0..1
+ *                M76_PLC              mains cycles per conversion 1..6
+ *                M76_ADAPT            noise-adaptive filter       0..0xffffff
+ *                                     target [LSB] (0=off)
+ *                M76_ZCAL             background zero-scale       M76_ZCAL_xxx
+ *                                     self-calibration
+ *                M76_ZCAL_PERIOD      self-calibration period     1..max ms
+ *                M76_BLK_RANGE_DEF    define custom range preset  M76_RANGE_DEF
+ *                M76_TRC_LOG          register access log on/off  0..1
+ *                M76_TRC_CLEAR        clear trace counters/log    -
  *                M76_STORE_CALI    *) store calibration memory    UEE_MAGIC 
  *                                     in user EEPROM
  *                M76_BLK_CALI      *) write a value to            see below
  *                                     calibration memory
+ *                M76_BLK_CALI_BLOB *) load calibration memory     see below
+ *                                     image
  *                M76_DELMAGIC      *) delete magic word in        UEE_MAGIC
  *                                     user EEPROM
  *
@@ -673,13 +1150,241 @@ static int32 M76_Write(
  *                !               5 = Ux full-scale resistance              !
  *                !            data[1]  calibration value                   !
  *                !                                                         !
+ *                ! M76_BLK_CALI_BLOB replaces the whole calibration memory !
+ *                !           by a host-side image, e.g. right after open.  !
+ *                !           The user EEPROM is not touched.               !
+ *                !           Description of data block (u_int8):           !
+ *                !            M76_CALI_BLOB_MAGIC, M76_CALI_BLOB_VERSION,  !
+ *                !            M76_CALI_WORDS, then M76_CALI_WORDS words in !
+ *                !            user EEPROM order and the XORed checksum of  !
+ *                !            these words; each word stored MSB first.     !
+ *                !           The image is rejected (ERR_LL_ILL_PARAM) if   !
+ *                !           magic, version, word count or checksum is     !
+ *                !           wrong. An image exported with                 !
+ *                !           the M76_BLK_CALI_BLOB getstat can be restored.!
+ *                !           Only the ADC Calibration Registers of the     !
+ *                !           current range are written, the other ranges   !
+ *                !           are written when selected. Changed ranges are !
+ *                !           marked in M76_CALI_DIRTY.                     !
+ *                !                                                         !
  *                !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!        
  *
  *                M76_RANGE selects the measuring range
  *                for defines of M76_RANGE_xxx see m76_drv.h and hardware manual
  *
+ *                M76_RANGE_USER(n) selects a custom range preset, defined
+ *                by the descriptor (RANGE_USER_<n>) or M76_BLK_RANGE_DEF. 
+ *                It is a voltage/current range with the config word, ADC
+ *                channel, gain and polarity of the preset, e.g. DC_V0 with
+ *                gain 4 or a DC range unipolar. Filter word and settling 
+ *                time of the preset (if not 0) are set on selection; the
+ *                previous values are restored when another range is
+ *                selected, unless changed meanwhile by M76_FILTER, 
+ *                M76_PLC or M76_SETTLE. The
+ *                preset has its own calibration values: M76_CALI, 
+ *                M76_BLK_CALI and M76_BLK_CALI_JOB work on them, but they 
+ *                are not stored in user EEPROM (M76_STORE_CALI); get them
+ *                with the M76_BLK_RANGE_DEF getstat and reload them with 
+ *                the setstat or the descriptor. Undefined presets are 
+ *                rejected (ERR_LL_ILL_PARAM).
+ *
+ *                M76_BLK_RANGE_DEF defines or redefines a custom range 
+ *                preset (M76_RANGE_DEF, see m76_drv.h). If it is the 
+ *                current range, it is selected again.
+ *
  *                M76_SETTLE defines the time the driver waits after range/
  *                ADC channel was changed.
+ *
+ *                M76_ASYNC=1 makes M76_CALI (getstat) and M76_STORE_CALI 
+ *                start a job driven by an OSS alarm and return immediately.
+ *                The detected calibration value, progress and errors are
+ *                returned by the M76_BLK_JOB_STAT getstat. While the job is
+ *                running (M76_JOB_STATE = M76_JOB_BUSY) the alarm owns
+ *                the hardware: read/write functions and all status codes
+ *                except those which only read or change driver state 
+ *                return ERR_LL_DEV_BUSY.
+ *
+ *                M76_JOB_CANCEL stops a running job (M76_JOB_CANCELED). 
+ *                A canceled store first writes back the previous contents
+ *                of the words already written, M76_JOB_STATE stays 
+ *                M76_JOB_BUSY until the user EEPROM is restored. The 
+ *                asynchronous store skips words which are unchanged.
+ *
+ *                M76_OVS sets the oversampling of the current range
+ *                (default: 0). M76_Read then accumulates 2^k conversions
+ *                and returns their mean. Together with a faster filter
+ *                (M76_FILTER) this gives finer steps between rate and
+ *                resolution than the filter word alone.
+ *                M76_OVS_FRAC keeps up to 7 bits of the mean below the
+ *                24-bit LSB (default: 0), the value scale does not depend
+ *                on k. M76_OVS_RND selects rounding to nearest (default)
+ *                or truncation of the dropped bits; rounding keeps the
+ *                mean free of a -1/2 LSB bias, the ADC noise serves as
+ *                dither.
+ *
+ *                M76_PFILT selects a post-filter for M76_Read, applied to
+ *                the (oversampled) samples (default: M76_PFILT_NONE):
+ *                  M76_PFILT_BOX     moving average of N samples
+ *                  M76_PFILT_MEDIAN  median of N samples (spike rejection)
+ *                  M76_PFILT_IIR     first order IIR, y += (x-y) / 2^N
+ *                N is set by M76_PFILT_N (default: 8). The first read after
+ *                changing filter, range or post-filter reads N samples to
+ *                fill the window, further reads one sample each.
+ *
+ *                M76_STAT_ON enables the streaming statistics of the raw
+ *                conversions of M76_Read and of envelope records
+ *                (default: 0), see M76_BLK_STAT
+ *                getstat. M76_STAT_WIN sets the window length in 
+ *                conversions, 0 accumulates since clear (default: 0).
+ *                The window is limited to M76_STAT_WIN_MAX, so m2 can't
+ *                overflow even at full-scale variance. Accumulated since
+ *                clear, m2 saturates at 0xffffffffffffffff.
+ *                M76_STAT_CLEAR and M76_STAT_WIN restart the statistics,
+ *                a range change restarts the running window.
+ *
+ *                M76_ENV_N > 0 switches M76_BlockRead of the U/I ranges
+ *                to envelope records, see M76_BlockRead (default: 0).
+ *
+ *                M76_DB_ABS/M76_DB_REL set a dead-band for M76_Read, in
+ *                codes of the returned value and in ppm of the last 
+ *                returned value; the larger one applies (default: 0=off).
+ *                The relative band refers to the signed value, i.e. to
+ *                the distance from code 0x800000 in bipolar (DC) ranges.
+ *                Values within the dead-band are dropped in the driver,
+ *                but a value is returned at least every M76_DB_HEART ms
+ *                (default: 1000, must be > 0 since the read holds the
+ *                device). Changing range, M76_OVS_FRAC or the dead-band
+ *                lets the next value pass.
+ *
+ *                M76_TRG_MODE != M76_TRG_OFF switches M76_BlockRead of the
+ *                U/I ranges to trigger records, see M76_BlockRead (default:
+ *                M76_TRG_OFF, level 0x800000, level2 0xffffff, 0 pre and
+ *                1 post sample, timeout 10000 ms). The timeout must be
+ *                > 0 since the read holds the device while waiting.
+ *
+ *                M76_ALM_ON enables the limit alarms (default: 0). Every
+ *                raw conversion read is checked against M76_ALM_HIGH and
+ *                M76_ALM_LOW (default: 0xffffff, 0). Exceeding a limit
+ *                latches M76_ALM_HI/M76_ALM_LO and sends the signal 
+ *                installed with M76_SIG_SET once; the alarm rearms when
+ *                the code returns M76_ALM_HYST (default: 0) inside the
+ *                limit. M76_ALM_STATE clears the given latched bits.
+ *
+ *                M76_NBLOCK makes M76_Read non-blocking (default: 
+ *                M76_NBLOCK_OFF) and starts a conversion; M76_Read returns
+ *                M76_ERR_NODATA until it is finished. With interrupts
+ *                enabled, the signal installed with M76_RDY_SIG_SET is
+ *                sent from the interrupt when a conversion is ready.
+ *                With M76_NBLOCK_LATEST and interrupts enabled, M76_Irq
+ *                fetches each conversion and starts the next one, without
+ *                interrupts M76_Read does so when it finds one ready.
+ *                Streaming statistics and limit alarms are done by 
+ *                M76_Read, not in the interrupt, so in latest mode they
+ *                see the latest conversion of each read only.
+ *                M76_BlockRead and any reconfiguration still block and
+ *                discard the started conversion; the latest value is 
+ *                invalid until a new conversion is ready.
+ *
+ *                M76_PACE_PERIOD > 0 starts paced sampling of the U/I
+ *                ranges: a cyclic OSS alarm fetches the conversion 
+ *                started in the last period, queues it with its period
+ *                number and time, and starts the next one. The records 
+ *                (M76_PACE_REC) are read with M76_BlockRead. The queue
+ *                holds M76_PACE_SIZE records (default: 256), further 
+ *                records are lost (M76_PACE_LOST). A period without 
+ *                finished conversion is counted (M76_PACE_LATE), so the
+ *                period must exceed the conversion time of the filter.
+ *                When M76_PACE_WMARK records (default: 1) are queued the
+ *                M76_RDY_SIG_SET signal is sent. While sampling runs all
+ *                functions that access the hardware and M76_RDY_SIG_SET/
+ *                M76_RDY_SIG_CLR return ERR_LL_DEV_BUSY. Streaming 
+ *                statistics and limit alarms are done when the records
+ *                are read (M76_BlockRead), not in the alarm; lost records
+ *                are not included. M76_PACE_PERIOD = 0 stops sampling and
+ *                discards the queue.
+ *
+ *                M76_FORMAT selects the format of the values of M76_Read
+ *                and of the resistance and trigger samples of 
+ *                M76_BlockRead (default: M76_FMT_WORD). M76_FMT_STATUS
+ *                puts overrange (code 0xffffff, 0xffff00 with M76_FAST),
+ *                underrange (code 0), invalid calibration checksum (read
+ *                with M76_PERMIT) and the range into the upper byte; it
+ *                can't be combined with M76_OVS_FRAC > 0. M76_FMT_PACKED
+ *                stores each code in 3 bytes, MSB first, and saves 25% of
+ *                the block size; M76_Read returns words then.
+ *
+ *                M76_PLC selects a filter word whose conversion time is
+ *                a whole number of mains cycles (MAINS_FREQ descriptor
+ *                key), so the notches of the sinc^3 filter fall on the 
+ *                mains frequency and its harmonics. Fewer cycles give a
+ *                higher rate, more cycles a lower noise (M76_PLC_xxx):
+ *
+ *                  cycles   50 Hz: rate  settle   60 Hz: rate  settle
+ *                  1               50 Hz  60 ms          60 Hz  50 ms
+ *                  2               25 Hz 120 ms          30 Hz 100 ms
+ *                  3            16.67 Hz 180 ms          20 Hz 150 ms
+ *                  4             12.5 Hz 240 ms          15 Hz 200 ms
+ *                  5               10 Hz 300 ms          12 Hz 250 ms
+ *                  6                 -                   10 Hz 300 ms
+ *
+ *                The M76_PLC getstat returns the cycles of the current 
+ *                filter word, also if set by M76_FILTER, or 0 if it is 
+ *                not mains-synchronous. M76_FILT_RATE and M76_FILT_SETTLE
+ *                return conversion rate and settle time of any filter 
+ *                word; M76_SETTLE should not be below the settle time.
+ *
+ *                M76_ADAPT > 0 enables the noise-adaptive filter with the
+ *                given target noise rms in 24-bit LSBs (default: 0, off).
+ *                The driver estimates the noise from the variance of the
+ *                differences of consecutive conversions (var = E[d^2]/2,
+ *                insensitive to slow signal changes) over 16 differences.
+ *                If it is above the target, the filter word is doubled 
+ *                (half rate), if it is below half the target, the word is
+ *                halved (double rate, about 1.4 times the noise). The 
+ *                band in between is the hysteresis. The step is done by 
+ *                M76_Read after its value, by the envelope and trigger 
+ *                M76_BlockRead after its records, and settles 
+ *                (M76_SETTLE); the estimate restarts after each settle, 
+ *                so resistance ranges, which settle per channel switch,
+ *                and paced sampling, which doesn't estimate, are not 
+ *                adapted.
+ *                A target in engineering units is converted by the
+ *                application with the scale of the range. M76_ADAPT_NOISE
+ *                returns the last estimate, M76_FILTER the current word.
+ *                Steps are logged as M76_EV_ADAPT. Note: the adapted words
+ *                are not mains-synchronous in general (see M76_PLC).
+ *
+ *                M76_ZCAL enables the background zero-scale 
+ *                self-calibration (default: M76_ZCAL_OFF). Every 
+ *                M76_ZCAL_PERIOD ms (default: 60000) a blocking M76_Read
+ *                runs a zero-scale self-calibration of the ADC (inputs 
+ *                shorted internally) before its conversion and restores
+ *                the zero-scale register. The first one after a settle 
+ *                (range, filter change) is done at once and is the base,
+ *                the drift of later ones against it is the offset drift
+ *                of the ADC. M76_ZCAL_TRACK only tracks it, 
+ *                M76_ZCAL_APPLY writes the stored zero-scale value plus 
+ *                the drift to the ADC. The self-calibration does not 
+ *                replace the stored system calibration, which includes 
+ *                the offset of the input path. A value read after a 
+ *                self-calibration is marked by M76_ZCAL_FLAG (getstat),
+ *                with M76_ZCAL_APPLY its offset may step by the drift.
+ *                A self-calibration takes about 4 conversions. Not done
+ *                for non-blocking reads, block reads and paced sampling.
+ *
+ *                M76_FAST=1 sets the ADC data word length to 16 bit 
+ *                (default: 0, 24 bit). A conversion is then fetched with
+ *                one bus read of the data register instead of two, and
+ *                the code is scaled to the 24-bit range, so limits,
+ *                levels and calibration of the driver and application 
+ *                stay valid at 16-bit resolution. The conversion rate is
+ *                still set by the filter (M76_FILTER). Switching settles.
+ *
+ *                M76_EVT_ON enables the event trace (default: 1), see
+ *                M76_BLK_EVT getstat. M76_EVT_CLEAR empties the ring.
+ *
+ *                M76_TRC_LOG/M76_TRC_CLEAR are only supported by a driver
+ *                built with switch M76_TRACE. Enabling the log restarts it.
  *---------------------------------------------------------------------------
  *  Input......:  llHdl             low-level handle
  *                code              status code
@@ -704,6 +1409,41 @@ static int32 M76_SetStat(
     DBGWRT_1((DBH, "LL - M76_SetStat: ch=%d code=0x%04x value=0x%x\n",
               ch,code,value));
 
+    /* only a few codes allowed while asynchronous job/paced sampling runs */
+    if ((llHdl->jobState == M76_JOB_BUSY) || llHdl->pacePeriod)  {
+        switch(code) {
+            case M76_PACE_PERIOD:
+            case M76_PACE_WMARK:
+                if (llHdl->jobState == M76_JOB_BUSY)
+                    return(ERR_LL_DEV_BUSY);
+                break;
+            case M76_RDY_SIG_SET:       /* used by PaceAlarm */
+            case M76_RDY_SIG_CLR:
+                if (llHdl->pacePeriod)
+                    return(ERR_LL_DEV_BUSY);
+                break;
+            case M_LL_DEBUG_LEVEL:
+            case M_LL_IRQ_COUNT:
+            case M76_PERMIT:
+            case M76_JOB_CANCEL:
+            case M76_EVT_ON:
+            case M76_EVT_CLEAR:
+            case M76_ACQ_CLEAR:
+            case M76_STAT_ON:
+            case M76_STAT_CLEAR:
+            case M76_ALM_STATE:
+            case M76_SIG_SET:
+            case M76_SIG_CLR:
+#ifdef M76_TRACE
+            case M76_TRC_LOG:
+            case M76_TRC_CLEAR:
+#endif
+                break;
+            default:
+                return(ERR_LL_DEV_BUSY);
+        }
+    }
+
     switch(code) {
 
         /*--------------------------+
@@ -716,6 +1456,7 @@ static int32 M76_SetStat(
         |  enable interrupts        |
         +--------------------------*/
         case M_MK_IRQ_ENABLE:
+            NbCancel(llHdl);
             if (value)  {
                 llHdl->irqEnable = TRUE;
             }
@@ -740,229 +1481,7 @@ static int32 M76_SetStat(
         |  range                    |
         +--------------------------*/
         case M76_RANGE:
-            switch(value) {
-            case M76_RANGE_DC_V0:
-                llHdl->conMode = DC_V0;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_DC_V1:
-                llHdl->conMode = DC_V1;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_DC_V2:
-                llHdl->conMode = DC_V2;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_DC_V3:
-                llHdl->conMode = DC_V3;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_DC_V4:
-                llHdl->conMode = DC_V4;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_AC_V0:
-                llHdl->conMode = AC_V0;
-                llHdl->comChan = COM_AC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_AC_V1:
-                llHdl->conMode = AC_V1;
-                llHdl->comChan = COM_AC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_AC_V2:
-                llHdl->conMode = AC_V2;
-                llHdl->comChan = COM_AC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_AC_V3:
-                llHdl->conMode = AC_V3;
-                llHdl->comChan = COM_AC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_DC_A0:
-                llHdl->conMode = DC_A0;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_DC_A1:
-                llHdl->conMode = DC_A1;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_DC_A2:
-                llHdl->conMode = DC_A2;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_DC_A3:
-                llHdl->conMode = DC_A3;
-                llHdl->comChan = COM_DC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_BI;
-                break;
-
-            case M76_RANGE_AC_A0:
-                llHdl->conMode = AC_A0;
-                llHdl->comChan = COM_AC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_AC_A1:
-                llHdl->conMode = AC_A1;
-                llHdl->comChan = COM_AC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_AC_A2:
-                llHdl->conMode = AC_A2;
-                llHdl->comChan = COM_AC;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R2_0:
-                llHdl->conMode = R2_1;  
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_4; 
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R2_1:
-                llHdl->conMode = R2_1;
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R2_2:
-                llHdl->conMode = R2_2;
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R2_3:
-                llHdl->conMode = R2_3;
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R2_4:
-                llHdl->conMode = R2_4;
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R4_0:
-                llHdl->conMode = R4_1;   
-                llHdl->comChan = COM_R_U;
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_4; 
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R4_1:
-                llHdl->conMode = R4_1;
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R4_2:
-                llHdl->conMode = R4_2;
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R4_3:
-                llHdl->conMode = R4_3;
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            case M76_RANGE_R4_4:
-                llHdl->conMode = R4_4;
-                llHdl->comChan = COM_R_U;  
-                llHdl->modMode = MOD_NORMAL;
-                llHdl->modGain = MOD_GAIN_1;
-                llHdl->filPolarity = FHI_POLAR_UNI;
-                break;
-
-            default:
-                error = ERR_LL_ILL_PARAM;
-                break;
-            }
-            if (!error)  {
-                llHdl->range = value;
-                WriteConfigReg(llHdl);
-                WriteFilterReg(llHdl);      
-                WriteModeReg(llHdl);
-                
-                WriteCaliRegUpd(llHdl);/* write new cali val to ADC,*/
-                                       /*  update cali info */
-                OSS_Delay(llHdl->osHdl, llHdl->settleTime);
-            }
+            error = SetRange(llHdl, value);
             break;
         /*-----------------------------------------+
         |   permit measurment with wrong checksum  |
@@ -984,19 +1503,101 @@ static int32 M76_SetStat(
             }
             else  {
                 llHdl->settleTime = value;
+                llHdl->userSaved &= ~USER_SAV_SET;  /* keep on leave */
             }
             break;
         /*--------------------------+
         |  filter frequency         |
         +--------------------------*/
         case M76_FILTER:
-            if ((value < 20) || (value > 1920))  {
+            if ((value < FIL_MIN) || (value > FIL_MAX))  {
                 error = ERR_LL_ILL_PARAM;
             }
             else  {
                 llHdl->filFilter = (u_int16)(value & 0xffff);
+                llHdl->userSaved &= ~USER_SAV_FIL;  /* keep on leave */
+                WriteFilterReg(llHdl);
+                Settle(llHdl);
+                llHdl->pfCnt = 0;           /* restart post-filter */
+            }
+            break;
+        /*--------------------------+
+        |  16-bit fast mode         |
+        +--------------------------*/
+        case M76_FAST:
+            llHdl->fast = value ? TRUE : FALSE;
+            WriteFilterReg(llHdl);
+            Settle(llHdl);
+            llHdl->pfCnt = 0;
+            llHdl->dbValid = FALSE;
+            break;
+        /*--------------------------+
+        |  mains filter preset      |
+        +--------------------------*/
+        case M76_PLC:
+            if ((value < 1) || (value > M76_PLC_MAX(llHdl->mainsHz)))  {
+                error = ERR_LL_ILL_PARAM;
+            }
+            else  {
+                llHdl->filFilter = (u_int16)(FIL_FCLK / FIL_CLKDIV * value /
+                                             llHdl->mainsHz);
+                llHdl->userSaved &= ~USER_SAV_FIL;
                 WriteFilterReg(llHdl);
-                OSS_Delay(llHdl->osHdl, llHdl->settleTime);
+                Settle(llHdl);
+                llHdl->pfCnt = 0;
+            }
+            break;
+        /*--------------------------+
+        |  noise-adaptive filter    |
+        +--------------------------*/
+        case M76_ADAPT:
+            if ((value < 0) || (value > 0xffffff))  {
+                error = ERR_LL_ILL_PARAM;
+            }
+            else  {
+                llHdl->adaptTarget = value;
+                llHdl->adaptCnt    = 0;
+                llHdl->adaptReq    = 0;
+                llHdl->adaptNoise  = 0;
+            }
+            break;
+        /*--------------------------+
+        |  zero-scale self-cali.    |
+        +--------------------------*/
+        case M76_ZCAL:
+            if ((value < M76_ZCAL_OFF) || (value > M76_ZCAL_APPLY))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            if ((llHdl->zcalMode == M76_ZCAL_APPLY) && 
+                (value != M76_ZCAL_APPLY) && 
+                !RANGE_IS_R(llHdl->range))
+                WriteCaliReg(llHdl);    /* remove correction */
+            llHdl->zcalMode  = value;
+            llHdl->zcalValid = FALSE;
+            break;
+        case M76_ZCAL_PERIOD:
+            if (value < 1)  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->zcalPeriod = value;
+            llHdl->zcalTicks = MsToTicks(llHdl, value);
+            break;
+        /*------------------------------+
+        |   custom range preset         |
+        +------------------------------*/
+        case M76_BLK_RANGE_DEF:
+            {
+                M_SG_BLOCK *blk = (M_SG_BLOCK*)valueP;
+                M76_RANGE_DEF *def = (M76_RANGE_DEF*)blk->data;
+
+                if (blk->size < sizeof(M76_RANGE_DEF))
+                    return(ERR_LL_USERBUF);
+
+                error = UserRangeDef(llHdl, def);
+                if (!error && (def->range == llHdl->range))
+                    error = SetRange(llHdl, def->range);
             }
             break;
         /*------------------------------+
@@ -1015,11 +1616,36 @@ static int32 M76_SetStat(
                 error = WriteCaliVal(llHdl, data->mode, data->value);
                 
                 if (!error)  { 
+                    llHdl->caliDirty |= CALI_DIRTY(llHdl->range);
                     WriteCaliRegUpd(llHdl);/* write new cali val to ADC,*/
                                            /*  update cali info */
                 }
             }
             break;
+        /*------------------------------+
+        |   load calibration image      |
+        +------------------------------*/
+        case M76_BLK_CALI_BLOB:
+            {
+                M_SG_BLOCK *blk = (M_SG_BLOCK*)valueP;
+
+                if (blk->size < M76_CALI_BLOB_SIZE)
+                    return(ERR_LL_USERBUF);
+
+                if (CheckCaliBlob((u_int8*)blk->data))  {
+                    error = ERR_LL_ILL_PARAM;
+                    break;
+                }
+                llHdl->caliDirty |= CaliBlobToMem(llHdl, (u_int8*)blk->data);
+                llHdl->caliSrc = M76_CALI_SRC_BLOB;
+                /* valid checksum */
+                llHdl->checkSum = TRUE;
+                llHdl->permitMeas = TRUE;
+
+                WriteCaliRegUpd(llHdl);/* write new cali val to ADC,*/
+                                       /*  update cali info */
+            }
+            break;
         /*--------------------------+
         |   save cali values        |
         +--------------------------*/
@@ -1027,21 +1653,45 @@ static int32 M76_SetStat(
             if (value != UEE_MAGIC)  {
                 error = ERR_LL_ILL_PARAM;
             }
+            else if (llHdl->async)  {
+                error = JobStart(llHdl, M76_JOBTYPE_STORE, 0);
+            }
             else  {
                 error = WriteCaliProm(llHdl);
                 if (error == 0)  {
                     /* valid checksum */
                     llHdl->checkSum = TRUE;
                     llHdl->permitMeas = TRUE;
+                    llHdl->caliSrc = M76_CALI_SRC_EEPROM;
+                    llHdl->caliDirty = 0;
                 }
             }
             break;
         /*--------------------------+
-        |   delete uee magic word   |
+        |   asynchronous mode       |
         +--------------------------*/
-        case M76_DELMAGIC:
-            if (value != UEE_MAGIC)  {
-                error = ERR_LL_ILL_PARAM;
+        case M76_ASYNC:
+            if (value && (llHdl->jobAlarm == NULL))  {
+                error = OSS_AlarmCreate(llHdl->osHdl, JobAlarm, llHdl,
+                                        &llHdl->jobAlarm);
+                if (error)
+                    break;
+            }
+            llHdl->async = value ? TRUE : FALSE;
+            break;
+        /*--------------------------+
+        |   cancel job              |
+        +--------------------------*/
+        case M76_JOB_CANCEL:
+            if (llHdl->jobState == M76_JOB_BUSY)
+                llHdl->jobCancel = TRUE;
+            break;
+        /*--------------------------+
+        |   delete uee magic word   |
+        +--------------------------*/
+        case M76_DELMAGIC:
+            if (value != UEE_MAGIC)  {
+                error = ERR_LL_ILL_PARAM;
             }
             else  {
                 DBGWRT_2((DBH, " delete UEE_MAGIC word\n"));
@@ -1052,6 +1702,305 @@ static int32 M76_SetStat(
             }
             break;
         /*--------------------------+
+        |   event trace             |
+        +--------------------------*/
+        case M76_EVT_ON:
+            llHdl->evtOn = value ? TRUE : FALSE;
+            break;
+        case M76_EVT_CLEAR:
+            llHdl->evtCnt = 0;
+            break;
+        /*--------------------------+
+        |   post-filter             |
+        +--------------------------*/
+        case M76_PFILT:
+            if ((value < M76_PFILT_NONE) || (value > M76_PFILT_IIR) ||
+                ((value == M76_PFILT_IIR) && 
+                 (llHdl->pfN > M76_PFILT_IIR_MAX)))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->pfType = value;
+            llHdl->pfCnt = 0;
+            break;
+        case M76_PFILT_N:
+            if ((value < 1) || (value > PF_MAX) ||
+                ((llHdl->pfType == M76_PFILT_IIR) && 
+                 (value > M76_PFILT_IIR_MAX)))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->pfN = value;
+            llHdl->pfCnt = 0;
+            break;
+        /*--------------------------+
+        |   oversampling            |
+        +--------------------------*/
+        case M76_OVS:
+            if ((value < 0) || (value > M76_OVS_MAX) ||
+                (llHdl->range >= RANGE_MAX))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->ovsK[llHdl->range] = (u_int8)value;
+            llHdl->pfCnt = 0;
+            break;
+        case M76_OVS_FRAC:
+            if ((value < 0) || (value > M76_OVS_FRAC_MAX) ||
+                (value && (llHdl->fmt == M76_FMT_STATUS)))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->ovsFrac = value;
+            llHdl->pfCnt = 0;
+            llHdl->dbValid = FALSE;
+            break;
+        case M76_OVS_RND:
+            llHdl->ovsRnd = value ? TRUE : FALSE;
+            break;
+        /*--------------------------+
+        |   acquisition statistics  |
+        +--------------------------*/
+        case M76_ACQ_CLEAR:
+        {
+            OSS_IRQ_STATE irqState;
+
+            irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+            OSS_MemFill(llHdl->osHdl, sizeof(ACQ_STAT), (char*)&llHdl->acq, 0);
+            OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+            break;
+        }
+        /*--------------------------+
+        |   streaming statistics    |
+        +--------------------------*/
+        case M76_STAT_ON:
+            llHdl->statOn = value ? TRUE : FALSE;
+            break;
+        case M76_STAT_WIN:
+            if ((value < 0) || (value > M76_STAT_WIN_MAX))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->statWin = value;
+            /* fall through */
+        case M76_STAT_CLEAR:
+            llHdl->statWins = 0;
+            llHdl->statCur.count = 0;
+            llHdl->statLast.count = 0;
+            break;
+        /*--------------------------+
+        |   envelope                |
+        +--------------------------*/
+        case M76_ENV_N:
+            if (value < 0)  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->envN = value;
+            break;
+        /*--------------------------+
+        |   dead-band               |
+        +--------------------------*/
+        case M76_DB_ABS:
+            if (value < 0)  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->dbAbs = value;
+            llHdl->dbValid = FALSE;
+            break;
+        case M76_DB_REL:
+            if ((value < 0) || (value > 1000000))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->dbRel = value;
+            llHdl->dbValid = FALSE;
+            break;
+        case M76_DB_HEART:
+            if (value < 1)  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->dbHeart = value;
+            llHdl->dbHeartTicks = MsToTicks(llHdl, value);
+            llHdl->dbValid = FALSE;
+            break;
+        /*--------------------------+
+        |   trigger                 |
+        +--------------------------*/
+        case M76_TRG_MODE:
+            if ((value < M76_TRG_OFF) || (value > M76_TRG_WINDOW))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->trgMode = value;
+            break;
+        case M76_TRG_LEVEL:
+        case M76_TRG_LEVEL2:
+            if ((value < 0) || (value > 0xffffff))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            if (code == M76_TRG_LEVEL)
+                llHdl->trgLevel = value;
+            else
+                llHdl->trgLevel2 = value;
+            break;
+        case M76_TRG_PRE:
+            if ((value < 0) || (value > M76_TRG_MAX))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->trgPre = value;
+            break;
+        case M76_TRG_POST:
+            if ((value < 1) || (value > M76_TRG_MAX))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->trgPost = value;
+            break;
+        case M76_TRG_TOUT:
+            if (value < 1)  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->trgTout = value;
+            llHdl->trgToutTicks = MsToTicks(llHdl, value);
+            break;
+        /*--------------------------+
+        |   limit alarms            |
+        +--------------------------*/
+        case M76_ALM_ON:
+            llHdl->almOn = value ? TRUE : FALSE;
+            llHdl->almState &= ~(M76_ALM_HI_ACT | M76_ALM_LO_ACT);
+            break;
+        case M76_ALM_HIGH:
+        case M76_ALM_LOW:
+        case M76_ALM_HYST:
+            if ((value < 0) || (value > 0xffffff))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            if (code == M76_ALM_HIGH)
+                llHdl->almHigh = value;
+            else if (code == M76_ALM_LOW)
+                llHdl->almLow = value;
+            else
+                llHdl->almHyst = value;
+            llHdl->almState &= ~(M76_ALM_HI_ACT | M76_ALM_LO_ACT);
+            break;
+        case M76_ALM_STATE:
+            llHdl->almState &= ~(value & (M76_ALM_HI | M76_ALM_LO));
+            break;
+        case M76_SIG_SET:
+            if (llHdl->almSig)  {
+                error = ERR_OSS_SIG_SET;
+                break;
+            }
+            error = OSS_SigCreate(llHdl->osHdl, value, &llHdl->almSig);
+            break;
+        case M76_SIG_CLR:
+            if (llHdl->almSig == NULL)  {
+                error = ERR_OSS_SIG_CLR;
+                break;
+            }
+            error = OSS_SigRemove(llHdl->osHdl, &llHdl->almSig);
+            break;
+        /*--------------------------+
+        |   non-blocking read       |
+        +--------------------------*/
+        case M76_NBLOCK:
+            if ((value < M76_NBLOCK_OFF) || (value > M76_NBLOCK_LATEST))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            NbCancel(llHdl);
+            llHdl->nbOn = value;
+            llHdl->ltSeq = 0;
+            if (llHdl->nbOn)
+                NbStart(llHdl);
+            break;
+        case M76_RDY_SIG_SET:
+            if (llHdl->rdySig)  {
+                error = ERR_OSS_SIG_SET;
+                break;
+            }
+            error = OSS_SigCreate(llHdl->osHdl, value, &llHdl->rdySig);
+            break;
+        case M76_RDY_SIG_CLR:
+        {
+            OSS_SIG_HANDLE *sig;
+            OSS_IRQ_STATE irqState;
+
+            if (llHdl->rdySig == NULL)  {
+                error = ERR_OSS_SIG_CLR;
+                break;
+            }
+            /* detach from M76_Irq before removing it */
+            irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+            sig = llHdl->rdySig;
+            llHdl->rdySig = NULL;
+            OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+            error = OSS_SigRemove(llHdl->osHdl, &sig);
+            break;
+        }
+        /*--------------------------+
+        |   paced sampling          |
+        +--------------------------*/
+        case M76_PACE_PERIOD:
+            if (llHdl->pacePeriod)
+                PaceStop(llHdl);
+            if (value)
+                error = PaceStart(llHdl, value);
+            break;
+        case M76_PACE_SIZE:
+            if ((value < 1) || (value > M76_PACE_MAX))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->paceSize = value;
+            if (llHdl->paceWmark > llHdl->paceSize)
+                llHdl->paceWmark = llHdl->paceSize;
+            break;
+        case M76_PACE_WMARK:
+            if ((value < 1) || ((u_int32)value > llHdl->paceSize))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->paceWmark = value;
+            break;
+        /*--------------------------+
+        |   block read format       |
+        +--------------------------*/
+        case M76_FORMAT:
+            if ((value < M76_FMT_WORD) || (value > M76_FMT_PACKED) ||
+                ((value == M76_FMT_STATUS) && llHdl->ovsFrac))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            llHdl->fmt = value;
+            break;
+#ifdef M76_TRACE
+        /*--------------------------+
+        |   bus access trace        |
+        +--------------------------*/
+        case M76_TRC_LOG:
+            if (value && !llHdl->trc->logOn)
+                llHdl->trc->logCnt = 0;     /* restart log */
+            llHdl->trc->logOn = value ? TRUE : FALSE;
+            break;
+        case M76_TRC_CLEAR:
+        {
+            u_int32 logOn = llHdl->trc->logOn;
+
+            OSS_MemFill(llHdl->osHdl, sizeof(M76_TRC), (char*)llHdl->trc, 0x00);
+            llHdl->trc->logOn = logOn;
+            break;
+        }
+#endif
+        /*--------------------------+
         |  (unknown)                |
         +--------------------------*/
         default:
@@ -1087,7 +2036,70 @@ static int32 M76_SetStat(
  *                                     wrong checksum
  *                M76_CINFO            calibration info of current 0..1
  *                                     range
+ *                M76_CALI_SRC         source of calibration       0..2
+ *                                     memory
+ *                M76_CALI_DIRTY       ranges changed, not stored  bit mask
+ *                M76_BLK_CALI_BLOB    export calibration memory   see below
+ *                                     image
+ *                M76_ASYNC            asynchronous mode           0..1
+ *                M76_JOB_STATE        state of asynchronous job   M76_JOB_xxx
+ *                M76_BLK_JOB_STAT     state, progress, result     M76_JOB_STAT
+ *                                     of asynchronous job
+ *                M76_EVT_ON           event trace on/off          0..1
+ *                M76_BLK_EVT          event trace                 M76_EVT_LOG
+ *                M76_BLK_ACQ_STAT     acquisition statistics      M76_ACQ_STAT
+ *                M76_PFILT            post-filter type            M76_PFILT_xxx
+ *                M76_PFILT_N          post-filter length/shift    1..64
+ *                M76_OVS              oversampling 2^k            0..8
+ *                                     (current range)
+ *                M76_OVS_FRAC         fraction bits of value      0..7
+ *                M76_OVS_RND          round/truncate              0..1
+ *                M76_STAT_ON          streaming statistics on/off 0..1
+ *                M76_STAT_WIN         statistics window length    0..1024
+ *                M76_BLK_STAT         streaming statistics        M76_STAT
+ *                M76_ENV_N            conversions per envelope    0..max
+ *                                     record (0=off)
+ *                M76_DB_ABS           dead-band [codes] (0=off)   0..max
+ *                M76_DB_REL           dead-band [ppm] (0=off)     0..1000000
+ *                M76_DB_HEART         dead-band heartbeat [ms]    1..max
+ *                M76_TRG_MODE         trigger mode                M76_TRG_xxx
+ *                M76_TRG_LEVEL        trigger level/window low    0..0xffffff
+ *                M76_TRG_LEVEL2       trigger window high         0..0xffffff
+ *                M76_TRG_PRE          pre-trigger samples         0..65536
+ *                M76_TRG_POST         post-trigger samples        1..65536
+ *                M76_TRG_TOUT         trigger timeout [ms]        1..max
+ *                M76_ALM_ON           limit alarms on/off         0..1
+ *                M76_ALM_HIGH         high alarm limit            0..0xffffff
+ *                M76_ALM_LOW          low alarm limit             0..0xffffff
+ *                M76_ALM_HYST         alarm hysteresis            0..0xffffff
+ *                M76_ALM_STATE        alarm state                 M76_ALM_xxx
+ *                M76_NBLOCK           non-blocking read mode      M76_NBLOCK_xxx
+ *                M76_BLK_LATEST       latest conversion           M76_LATEST
+ *                M76_PACE_PERIOD      paced sampling period [ms]  0..max
+ *                M76_PACE_SIZE        paced sampling queue size   1..65536
+ *                M76_PACE_WMARK       paced sampling watermark    1..size
+ *                M76_PACE_LOST        records lost (queue full)   0..max
+ *                M76_PACE_LATE        periods without conversion  0..max
+ *                M76_FORMAT           sample format               M76_FMT_xxx
+ *                M76_FAST             16-bit fast mode on/off     0..1
+ *                M76_PLC              mains cycles per conversion 0..6
+ *                                     (0=not synchronous)
+ *                M76_FILT_RATE        conversion rate [mHz]       0..max
+ *                M76_FILT_SETTLE      filter settle time [ms]     0..max
+ *                M76_ADAPT            noise-adaptive filter       0..0xffffff
+ *                                     target [LSB] (0=off)
+ *                M76_ADAPT_NOISE      estimated noise rms [LSB]   0..max
+ *                M76_ZCAL             background zero-scale       M76_ZCAL_xxx
+ *                                     self-calibration
+ *                M76_ZCAL_PERIOD      self-calibration period     1..max ms
+ *                M76_ZCAL_FLAG        last value read after       0..1
+ *                                     self-calibration
+ *                M76_BLK_ZCAL         self-calibration offset     M76_ZCAL_INFO
+ *                M76_BLK_RANGE_DEF    custom range preset         M76_RANGE_DEF
+ *                M76_TRC_LOG          register access log on/off  0..1
+ *                M76_BLK_TRC          bus access trace            M76_TRC
  *                M76_CALI          *) calibrates current range    see below
+ *                M76_BLK_CALI_JOB  *) calibrates list of ranges   see below
  *
  *                !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! 
  *                !*) Note:  MEN carries out an initial calibration. The    !
@@ -1108,6 +2120,20 @@ static int32 M76_SetStat(
  *                !            5 = Ux full-scale resistance                 !
  *                !           modified value:                               !
  *                !            detected calibration value                   !
+ *                !           With M76_ASYNC=1 the calibration is started   !
+ *                !           and the value is returned by M76_BLK_JOB_STAT.!
+ *                !                                                         !
+ *                ! M76_BLK_CALI_JOB performs a list of calibrations        !
+ *                !           (M76_CALI_JOB, see m76_drv.h) and writes the  !
+ *                !           detected values to calibration memory.        !
+ *                !           The steps are executed grouped by range       !
+ *                !           (current range first), zero-scale before      !
+ *                !           full-scale, Ux before Im. The Im channel is   !
+ *                !           selected only once per range. Value and error !
+ *                !           code of each step are returned in the step.   !
+ *                !           The previous range is restored at the end.    !
+ *                !           With M76_CALI_JOB_STORE the calibration memory!
+ *                !           is stored in user EEPROM if all steps passed. !
  *                !                                                         !
  *                !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!        
  *
@@ -1121,6 +2147,65 @@ static int32 M76_SetStat(
  *
  *                M76_CINFO if a word in user EEPROM is 0xffff for the 
  *                     selected range, M76_CINFO returns 0, else 1
+ *
+ *                M76_CALI_SRC returns where the calibration memory came from
+ *                     0 = M76_CALI_SRC_EEPROM  user EEPROM
+ *                     1 = M76_CALI_SRC_BLOB    calibration image
+ *                     2 = M76_CALI_SRC_DIFF    calibration image, differs
+ *                                              from user EEPROM
+ *
+ *                M76_CALI_DIRTY returns a bit mask (bit n = range n) of the
+ *                     ranges whose calibration memory was changed since init
+ *                     or the last M76_STORE_CALI
+ *
+ *                M76_BLK_CALI_BLOB copies the whole calibration memory 
+ *                     to the user buffer in the image format of the 
+ *                     M76_BLK_CALI_BLOB setstat (M76_CALI_BLOB_SIZE bytes,
+ *                     header, words MSB first, XORed checksum at end). The 
+ *                     image can be restored with the setstat or used as 
+ *                     descriptor key CALI_BLOB.
+ *
+ *                M76_BLK_EVT copies the latest events of the event ring
+ *                     (up to M76_EVT_MAX, oldest first) that fit into the
+ *                     user buffer (M76_EVT_LOG, see m76_drv.h). Each event
+ *                     has a timestamp, an id (M76_EV_xxx) and two args.
+ *                     The ring is written with a few stores from all
+ *                     contexts incl. interrupt, unlike DBGWRT it does
+ *                     not change the timing noticeably.
+ *
+ *                M76_BLK_ACQ_STAT copies the acquisition counters (reads,
+ *                     timeouts, interrupts, settle delays) and the log2 
+ *                     histograms of conversion latency, interrupt to 
+ *                     wakeup latency and settle time (M76_ACQ_STAT, see
+ *                     m76_drv.h). M76_ACQ_CLEAR setstat resets them.
+ *
+ *                M76_BLK_STAT copies the streaming statistics (M76_STAT,
+ *                     see m76_drv.h) of the running and the last completed
+ *                     window: count, min, max, mean and sum of squared
+ *                     deviations (Welford) of the raw 24-bit conversions,
+ *                     mean and m2 with M76_STAT_Q fraction bits. A long
+ *                     test needs only one getstat at the end.
+ *
+ *                M76_BLK_LATEST copies the latest conversion of the
+ *                     non-blocking read (M76_LATEST, see m76_drv.h) with
+ *                     its sequence number and age. Returns M76_ERR_NODATA
+ *                     if there is none for the current setup.
+ *
+ *                M76_BLK_ZCAL copies the zero-scale values of the 
+ *                     background self-calibration (M76_ZCAL_INFO, see
+ *                     m76_drv.h) to compare them with the calibration
+ *                     memory. Returns M76_ERR_NODATA if there is no base
+ *                     for the current range.
+ *
+ *                M76_BLK_RANGE_DEF copies the custom range preset given
+ *                     by the range member (M76_RANGE_DEF, see m76_drv.h)
+ *                     incl. its current calibration values. Returns 
+ *                     M76_ERR_NODATA if the preset is not defined.
+ *
+ *                M76_BLK_TRC copies the bus access counters per scope
+ *                     (M76_TRC_SC_xxx) and the register access log 
+ *                     (M76_TRC, see m76_drv.h). Only supported by a driver
+ *                     built with switch M76_TRACE.
  *---------------------------------------------------------------------------
  *  Input......:  llHdl             low-level handle
  *                code              status code
@@ -1149,6 +2234,86 @@ static int32 M76_GetStat(
     DBGWRT_1((DBH, "LL - M76_GetStat: ch=%d code=0x%04x\n",
               ch,code));
 
+    /* no hardware access while asynchronous job/paced sampling runs, 
+       only codes which read driver state are allowed */
+    if ((llHdl->jobState == M76_JOB_BUSY) || llHdl->pacePeriod)  {
+        switch(code) {
+            case M_LL_DEBUG_LEVEL:
+            case M_LL_CH_NUMBER:
+            case M_LL_CH_DIR:
+            case M_LL_CH_LEN:
+            case M_LL_CH_TYP:
+            case M_LL_IRQ_COUNT:
+            case M_LL_ID_CHECK:
+            case M_LL_ID_SIZE:
+            case M_MK_BLK_REV_ID:
+            case M76_RANGE:
+            case M76_CHECKSUM:
+            case M76_SETTLE:
+            case M76_FILTER:
+            case M76_PERMIT:
+            case M76_CINFO:
+            case M76_CALI_SRC:
+            case M76_CALI_DIRTY:
+            case M76_BLK_CALI_BLOB:
+            case M76_ASYNC:
+            case M76_JOB_STATE:
+            case M76_BLK_JOB_STAT:
+            case M76_EVT_ON:
+            case M76_PFILT:
+            case M76_PFILT_N:
+            case M76_OVS:
+            case M76_OVS_FRAC:
+            case M76_OVS_RND:
+            case M76_BLK_EVT:
+            case M76_BLK_ACQ_STAT:
+            case M76_STAT_ON:
+            case M76_STAT_WIN:
+            case M76_ENV_N:
+            case M76_DB_ABS:
+            case M76_DB_REL:
+            case M76_DB_HEART:
+            case M76_TRG_MODE:
+            case M76_TRG_LEVEL:
+            case M76_TRG_LEVEL2:
+            case M76_TRG_PRE:
+            case M76_TRG_POST:
+            case M76_TRG_TOUT:
+            case M76_ALM_ON:
+            case M76_ALM_HIGH:
+            case M76_ALM_LOW:
+            case M76_ALM_HYST:
+            case M76_ALM_STATE:
+            case M76_NBLOCK:
+            case M76_PACE_PERIOD:
+            case M76_PACE_SIZE:
+            case M76_PACE_WMARK:
+            case M76_PACE_LOST:
+            case M76_PACE_LATE:
+            case M76_FORMAT:
+            case M76_FAST:
+            case M76_PLC:
+            case M76_FILT_RATE:
+            case M76_FILT_SETTLE:
+            case M76_ADAPT:
+            case M76_ADAPT_NOISE:
+            case M76_ZCAL:
+            case M76_ZCAL_PERIOD:
+            case M76_ZCAL_FLAG:
+            case M76_BLK_STAT:
+            case M76_BLK_LATEST:
+            case M76_BLK_ZCAL:
+            case M76_BLK_RANGE_DEF:
+#ifdef M76_TRACE
+            case M76_TRC_LOG:
+            case M76_BLK_TRC:
+#endif
+                break;
+            default:
+                return(ERR_LL_DEV_BUSY);
+        }
+    }
+
     switch(code)
     {
         /*--------------------------+
@@ -1253,80 +2418,537 @@ static int32 M76_GetStat(
             *valueP = llHdl->calibOk;
             break;
         /*--------------------------+
+        |  cali source              |
+        +--------------------------*/
+        case M76_CALI_SRC:
+            *valueP = llHdl->caliSrc;
+            break;
+        /*--------------------------+
+        |  changed ranges           |
+        +--------------------------*/
+        case M76_CALI_DIRTY:
+            *valueP = llHdl->caliDirty;
+            break;
+        /*--------------------------+
+        |  export cali memory       |
+        +--------------------------*/
+        case M76_BLK_CALI_BLOB:
+            if (blk->size < M76_CALI_BLOB_SIZE)  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            CaliMemToBlob(llHdl, (u_int8*)blk->data);
+            blk->size = M76_CALI_BLOB_SIZE;
+            break;
+        /*--------------------------+
         |   calibration             |
         +--------------------------*/
         case M76_CALI:
-            error = CalibAdc(llHdl, valueP);
+            if (llHdl->async)
+                error = JobStart(llHdl, M76_JOBTYPE_CALI, *valueP);
+            else
+                error = CalibAdc(llHdl, valueP);
             break;
         /*--------------------------+
-        |  (unknown)                |
+        |   asynchronous job        |
         +--------------------------*/
-        default:
-            error = ERR_LL_UNK_CODE;
-    }
+        case M76_ASYNC:
+            *valueP = llHdl->async;
+            break;
+        case M76_JOB_STATE:
+            *valueP = llHdl->jobState;
+            break;
+        case M76_BLK_JOB_STAT:
+        {
+            M76_JOB_STAT *stat = (M76_JOB_STAT*)blk->data;
 
-    return(error);
-}
+            if (blk->size < sizeof(M76_JOB_STAT))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            stat->state = llHdl->jobState;
+            stat->type  = llHdl->jobType;
+            stat->error = llHdl->jobError;
+            stat->value = llHdl->jobValue;
+            if (stat->state != M76_JOB_BUSY)
+                stat->progress = (stat->state == M76_JOB_DONE) ? 100 : 0;
+            else if (llHdl->jobType == M76_JOBTYPE_CALI)
+                stat->progress = llHdl->jobStep * 100 / JS_CALI_NUM;
+            else
+                stat->progress = llHdl->jobIdx * 100 / (M76_CALI_WORDS+1);
+
+            blk->size = sizeof(M76_JOB_STAT);
+            break;
+        }
+        /*--------------------------+
+        |   calibration job         |
+        +--------------------------*/
+        case M76_BLK_CALI_JOB:
+        {
+            M76_CALI_JOB *job = (M76_CALI_JOB*)blk->data;
 
-/******************************* M76_BlockRead *******************************
- *
- *  Description:  Read a data block from the device, to be used for resistance
- *                measurements.
- *                First value is Ux, second value is Im.
- *                For measuring principle see hardware manual.
- *                Valid data is a 24-bit value. The bits are right-aligned in
- *                a 32-bit long word. The upper 8 bits are always zero.
- *                 
- *                  +------+
- *                  |  Ux  |    1st value
- *                  +------+
- *                  |  Im  |    2nd value
- *                  +------+
- *
- *                If the checksum test result is FALSE, an error is returned 
- *                as long as read is not explicitly allowed.
- *                If there are no valid calibration values for the selected 
- *                range an error is returned.
- *---------------------------------------------------------------------------
- *  Input......:  llHdl        low-level handle
- *                ch           current channel
- *                buf          data buffer
- *                size         data buffer size
- *  Output.....:  nbrRdBytesP  number of read bytes
- *                return       success (0) or error code
- *  Globals....:  ---
- ****************************************************************************/
-static int32 M76_BlockRead(
-     LL_HANDLE *llHdl,
-     int32     ch,
-     void      *buf,
-     int32     size,
-     int32     *nbrRdBytesP
-)
-{
-    int32 error = ERR_SUCCESS;
-    int32 *bufP = (int32*)buf;
-    u_int16 gain;
- 
-    DBGWRT_1((DBH, "LL - M76_BlockRead: ch=%d, size=%d\n",ch,size));
-    
-    if (llHdl->range < M76_RANGE_R2_0)
-        return(ERR_LL_ILL_PARAM);
-    
-    if (size < 8)
-        return(ERR_LL_USERBUF);
+            if ((blk->size < sizeof(M76_CALI_JOB)) || 
+                (blk->size < M76_CALI_JOB_SIZE(job->nSteps)))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            error = CalibJob(llHdl, job);
+            break;
+        }
+        /*--------------------------+
+        |   event trace             |
+        +--------------------------*/
+        case M76_EVT_ON:
+            *valueP = llHdl->evtOn;
+            break;
+        /*--------------------------+
+        |   post-filter             |
+        +--------------------------*/
+        case M76_PFILT:
+            *valueP = llHdl->pfType;
+            break;
+        case M76_PFILT_N:
+            *valueP = llHdl->pfN;
+            break;
+        /*--------------------------+
+        |   oversampling            |
+        +--------------------------*/
+        case M76_OVS:
+            if (llHdl->range >= RANGE_MAX)  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            *valueP = llHdl->ovsK[llHdl->range];
+            break;
+        case M76_OVS_FRAC:
+            *valueP = llHdl->ovsFrac;
+            break;
+        case M76_OVS_RND:
+            *valueP = llHdl->ovsRnd;
+            break;
+        case M76_BLK_EVT:
+        {
+            M76_EVT_LOG *log = (M76_EVT_LOG*)blk->data;
+            EVT_ENTRY *e;
+            u_int32 cnt = llHdl->evtCnt, n, i;
 
-    if (llHdl->permitMeas == FALSE)     /* wrong checksum */
+            if (blk->size < sizeof(M76_EVT_LOG))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            /* latest events fitting into user buffer, oldest first */
+            n = (blk->size - sizeof(M76_EVT_LOG)) / sizeof(M76_EVT) + 1;
+            if (n > EVT_NUM)
+                n = EVT_NUM;
+            if (n > cnt)
+                n = cnt;
+
+            log->total    = cnt;
+            log->tickRate = M76_EVT_RATE(llHdl);
+            log->num      = n;
+            log->reserved = 0;
+            for (i=0; i<n; i++)  {
+                e = &llHdl->evt[(cnt - n + i) % EVT_NUM];
+                log->evt[i].time   = e->time;
+                log->evt[i].id     = e->id;
+                log->evt[i].arg[0] = e->arg[0];
+                log->evt[i].arg[1] = e->arg[1];
+            }
+            blk->size = (int32)((u_int8*)&log->evt[n] - (u_int8*)log);
+            break;
+        }
+        /*--------------------------+
+        |   acquisition statistics  |
+        +--------------------------*/
+        case M76_BLK_ACQ_STAT:
+        {
+            M76_ACQ_STAT *st = (M76_ACQ_STAT*)blk->data;
+            ACQ_STAT *acq = &llHdl->acq;
+            OSS_IRQ_STATE irqState;
+            u_int32 i;
+
+            if (blk->size < sizeof(M76_ACQ_STAT))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            /* consistent copy, M76_Irq counts too */
+            irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+            st->tickRate = M76_EVT_RATE(llHdl);
+            st->reads    = acq->reads;
+            st->semTout  = acq->semTout;
+            st->pollTout = acq->pollTout;
+            st->irqs     = acq->irqs;
+            st->settles  = acq->settles;
+            st->settleMs = acq->settleMs;
+            st->reserved = 0;
+            for (i=0; i<ACQ_BINS; i++)  {
+                st->convLat[i] = acq->convLat[i];
+                st->irqWake[i] = acq->irqWake[i];
+                st->settle[i]  = acq->settle[i];
+            }
+            OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+            blk->size = sizeof(M76_ACQ_STAT);
+            break;
+        }
+        /*--------------------------+
+        |   streaming statistics    |
+        +--------------------------*/
+        case M76_STAT_ON:
+            *valueP = llHdl->statOn;
+            break;
+        case M76_STAT_WIN:
+            *valueP = llHdl->statWin;
+            break;
+        case M76_BLK_STAT:
+        {
+            M76_STAT *st = (M76_STAT*)blk->data;
+
+            if (blk->size < sizeof(M76_STAT))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            st->window  = llHdl->statWin;
+            st->windows = llHdl->statWins;
+            StatCopy(&st->cur, &llHdl->statCur);
+            StatCopy(&st->last, &llHdl->statLast);
+            blk->size = sizeof(M76_STAT);
+            break;
+        }
+        /*--------------------------+
+        |   envelope                |
+        +--------------------------*/
+        case M76_ENV_N:
+            *valueP = llHdl->envN;
+            break;
+        /*--------------------------+
+        |   dead-band               |
+        +--------------------------*/
+        case M76_DB_ABS:
+            *valueP = llHdl->dbAbs;
+            break;
+        case M76_DB_REL:
+            *valueP = llHdl->dbRel;
+            break;
+        case M76_DB_HEART:
+            *valueP = llHdl->dbHeart;
+            break;
+        /*--------------------------+
+        |   trigger                 |
+        +--------------------------*/
+        case M76_TRG_MODE:
+            *valueP = llHdl->trgMode;
+            break;
+        case M76_TRG_LEVEL:
+            *valueP = llHdl->trgLevel;
+            break;
+        case M76_TRG_LEVEL2:
+            *valueP = llHdl->trgLevel2;
+            break;
+        case M76_TRG_PRE:
+            *valueP = llHdl->trgPre;
+            break;
+        case M76_TRG_POST:
+            *valueP = llHdl->trgPost;
+            break;
+        case M76_TRG_TOUT:
+            *valueP = llHdl->trgTout;
+            break;
+        /*--------------------------+
+        |   limit alarms            |
+        +--------------------------*/
+        case M76_ALM_ON:
+            *valueP = llHdl->almOn;
+            break;
+        case M76_ALM_HIGH:
+            *valueP = llHdl->almHigh;
+            break;
+        case M76_ALM_LOW:
+            *valueP = llHdl->almLow;
+            break;
+        case M76_ALM_HYST:
+            *valueP = llHdl->almHyst;
+            break;
+        case M76_ALM_STATE:
+            *valueP = llHdl->almState;
+            break;
+        /*--------------------------+
+        |   non-blocking read       |
+        +--------------------------*/
+        case M76_NBLOCK:
+            *valueP = llHdl->nbOn;
+            break;
+        case M76_BLK_LATEST:
+        {
+            M76_LATEST *lt = (M76_LATEST*)blk->data;
+            u_int32 seq, t;
+
+            if (blk->size < sizeof(M76_LATEST))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            do {                        /* M76_Irq may update it */
+                seq = llHdl->ltSeq;
+                lt->value = llHdl->ltValue;
+                t = llHdl->ltTime;
+            } while (seq != llHdl->ltSeq);
+
+            if (!llHdl->ltValid)  {
+                error = M76_ERR_NODATA;
+                break;
+            }
+            lt->seq = seq;
+            lt->age = TicksToMs(llHdl, M76_EVT_TIME(llHdl) - t);
+            blk->size = sizeof(M76_LATEST);
+            break;
+        }
+        /*--------------------------+
+        |   paced sampling          |
+        +--------------------------*/
+        case M76_PACE_PERIOD:
+            *valueP = llHdl->pacePeriod;
+            break;
+        case M76_PACE_SIZE:
+            *valueP = llHdl->paceSize;
+            break;
+        case M76_PACE_WMARK:
+            *valueP = llHdl->paceWmark;
+            break;
+        case M76_PACE_LOST:
+            *valueP = llHdl->paceLost;
+            break;
+        case M76_PACE_LATE:
+            *valueP = llHdl->paceLate;
+            break;
+        /*--------------------------+
+        |   block read format       |
+        +--------------------------*/
+        case M76_FORMAT:
+            *valueP = llHdl->fmt;
+            break;
+        /*--------------------------+
+        |   16-bit fast mode        |
+        +--------------------------*/
+        case M76_FAST:
+            *valueP = llHdl->fast;
+            break;
+        /*--------------------------+
+        |   mains filter, rate      |
+        +--------------------------*/
+        case M76_PLC:
+            *valueP = FilterPlc(llHdl);
+            break;
+        case M76_FILT_RATE:
+            *valueP = (FIL_FCLK / FIL_CLKDIV * 1000 + llHdl->filFilter / 2) /
+                      llHdl->filFilter;
+            break;
+        case M76_FILT_SETTLE:   /* round up */
+            *valueP = (FIL_SETTLE * FIL_CLKDIV * 1000 * llHdl->filFilter +
+                       FIL_FCLK - 1) / FIL_FCLK;
+            break;
+        /*--------------------------+
+        |   noise-adaptive filter   |
+        +--------------------------*/
+        case M76_ADAPT:
+            *valueP = llHdl->adaptTarget;
+            break;
+        case M76_ADAPT_NOISE:
+            *valueP = llHdl->adaptNoise;
+            break;
+        /*--------------------------+
+        |   zero-scale self-cali.   |
+        +--------------------------*/
+        case M76_ZCAL:
+            *valueP = llHdl->zcalMode;
+            break;
+        case M76_ZCAL_PERIOD:
+            *valueP = llHdl->zcalPeriod;
+            break;
+        case M76_ZCAL_FLAG:
+            *valueP = llHdl->zcalFlag;
+            break;
+        case M76_BLK_ZCAL:
+        {
+            M76_ZCAL_INFO *zi = (M76_ZCAL_INFO*)blk->data;
+
+            if (blk->size < sizeof(M76_ZCAL_INFO))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            if (!llHdl->zcalValid)  {
+                error = M76_ERR_NODATA;
+                break;
+            }
+            zi->slots   = llHdl->zcalSlots;
+            zi->range   = llHdl->range;
+            zi->base    = llHdl->zcalBase;
+            zi->last    = llHdl->zcalLast;
+            zi->drift   = ((int32)((u_int32)(llHdl->zcalLast - 
+                                             llHdl->zcalBase) << 8)) >> 8;
+            zi->stored  = CaliVa(llHdl)->zero;
+            zi->applied = llHdl->zcalApplied;
+            zi->age     = TicksToMs(llHdl, M76_EVT_TIME(llHdl) - 
+                                    llHdl->zcalTime);
+            blk->size = sizeof(M76_ZCAL_INFO);
+            break;
+        }
+        /*--------------------------+
+        |   custom range preset     |
+        +--------------------------*/
+        case M76_BLK_RANGE_DEF:
+        {
+            M76_RANGE_DEF *def = (M76_RANGE_DEF*)blk->data;
+            USER_RANGE *u;
+
+            if (blk->size < sizeof(M76_RANGE_DEF))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            if ((def->range < RANGE_NUM) || (def->range >= RANGE_MAX))  {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+            u = &llHdl->user[def->range - RANGE_NUM];
+            if (!u->defined)  {
+                error = M76_ERR_NODATA;
+                break;
+            }
+            def->config   = u->config;
+            def->chan     = u->comChan;
+            def->gain     = u->modGain >> 2;
+            def->unipolar = (u->polarity == FHI_POLAR_UNI);
+            def->filter   = u->filter;
+            def->settle   = u->settle;
+            def->caliZero = u->cali.zero;
+            def->caliFull = u->cali.full;
+            blk->size = sizeof(M76_RANGE_DEF);
+            break;
+        }
+#ifdef M76_TRACE
+        /*--------------------------+
+        |   bus access trace        |
+        +--------------------------*/
+        case M76_TRC_LOG:
+            *valueP = llHdl->trc->logOn;
+            break;
+        case M76_BLK_TRC:
+            if (blk->size < sizeof(M76_TRC))  {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+            OSS_MemCopy(llHdl->osHdl, sizeof(M76_TRC), 
+                        (char*)llHdl->trc, (char*)blk->data);
+            blk->size = sizeof(M76_TRC);
+            break;
+#endif
+        /*--------------------------+
+        |  (unknown)                |
+        +--------------------------*/
+        default:
+            error = ERR_LL_UNK_CODE;
+    }
+
+    return(error);
+}
+
+/******************************* M76_BlockRead *******************************
+ *
+ *  Description:  Read a data block from the device, to be used for resistance
+ *                measurements.
+ *                First value is Ux, second value is Im.
+ *                For measuring principle see hardware manual.
+ *                Valid data is a 24-bit value. The bits are right-aligned in
+ *                a 32-bit long word. The upper 8 bits are always zero.
+ *                 
+ *                  +------+
+ *                  |  Ux  |    1st value
+ *                  +------+
+ *                  |  Im  |    2nd value
+ *                  +------+
+ *
+ *                With M76_ENV_N > 0 and a DC/AC current or voltage range
+ *                the block is filled with envelope records instead
+ *                (M76_ENV, see m76_drv.h): each record reduces M76_ENV_N 
+ *                raw conversions to min, max, mean and count. As many
+ *                records as fit into the buffer are read, e.g. one per
+ *                display frame with M76_ENV_N = conversion rate / frames.
+ *                Spikes show in min/max without one call per conversion.
+ *
+ *                With M76_TRG_MODE != M76_TRG_OFF and a DC/AC current or
+ *                voltage range (takes precedence over M76_ENV_N) the read
+ *                converts until the trigger condition on the raw codes
+ *                is met, keeping the last M76_TRG_PRE conversions, and
+ *                then reads M76_TRG_POST conversions from the trigger 
+ *                sample on. One record (M76_TRG_REC, see m76_drv.h) is
+ *                returned, the buffer must hold M76_TRG_REC_SIZE(pre+post)
+ *                bytes. Without trigger within M76_TRG_TOUT the read fails
+ *                with ERR_OSS_TIMEOUT.
+ *
+ *                While paced sampling runs (M76_PACE_PERIOD > 0) the
+ *                queued records (M76_PACE_REC, see m76_drv.h) are read, 
+ *                as many as fit into the buffer. The read waits until
+ *                M76_PACE_WMARK records or a full buffer are queued; in
+ *                non-blocking mode (M76_NBLOCK) it returns the queued
+ *                records or M76_ERR_NODATA at once.
+ *
+ *                M76_FORMAT applies to the resistance values and the 
+ *                samples of the trigger record; with M76_FMT_PACKED Ux 
+ *                and Im take 6 bytes.
+ *
+ *                If the checksum test result is FALSE, an error is returned 
+ *                as long as read is not explicitly allowed.
+ *                If there are no valid calibration values for the selected 
+ *                range an error is returned.
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl        low-level handle
+ *                ch           current channel
+ *                buf          data buffer
+ *                size         data buffer size
+ *  Output.....:  nbrRdBytesP  number of read bytes
+ *                return       success (0) or error code
+ *  Globals....:  ---
+ ****************************************************************************/
+static int32 M76_BlockRead(
+     LL_HANDLE *llHdl,
+     int32     ch,
+     void      *buf,
+     int32     size,
+     int32     *nbrRdBytesP
+)
+{
+    int32 error = ERR_SUCCESS;
+    int32 v[2];                     /* Ux, Im (formatted in place) */
+    u_int16 gain;
+ 
+    DBGWRT_1((DBH, "LL - M76_BlockRead: ch=%d, size=%d\n",ch,size));
+    
+    if (llHdl->jobState == M76_JOB_BUSY)    /* asynchronous job running */
+        return(ERR_LL_DEV_BUSY);
+
+    if (llHdl->pacePeriod)                  /* paced sampling */
+        return(PaceRead(llHdl, (M76_PACE_REC*)buf, size, nbrRdBytesP));
+
+    if (!RANGE_IS_R(llHdl->range) && llHdl->trgMode)     /* trigger */
+        return(TrgRead(llHdl, (M76_TRG_REC*)buf, size, nbrRdBytesP));
+
+    if (!RANGE_IS_R(llHdl->range) && llHdl->envN)        /* envelope */
+        return(EnvRead(llHdl, (M76_ENV*)buf, size, nbrRdBytesP));
+
+    if (!RANGE_IS_R(llHdl->range))
+        return(ERR_LL_ILL_PARAM);
+    
+    if (size < ((llHdl->fmt == M76_FMT_PACKED) ? 6 : 8))
+        return(ERR_LL_USERBUF);
+
+    if (llHdl->permitMeas == FALSE)     /* wrong checksum */
         return(ERR_LL_DEV_NOTRDY);
     if (llHdl->calibOk == FALSE)        /* not calibrated (Ux) */
         return(ERR_LL_DEV_NOTRDY);
     
     /* get Ux */
-    error = ReadDataReg(llHdl, bufP, COM_DATA);
+    error = ReadDataReg(llHdl, &v[0], COM_DATA);
     if (error)
         return(error);
-    *bufP >>= 8;
-    *bufP &= 0x00ffffff;
+    v[0] = (v[0] >> 8) & 0x00ffffff;
     
     /* get Im */
     gain = llHdl->modGain;          /* save Ux gain */
@@ -1337,14 +2959,12 @@ static int32 M76_BlockRead(
     WriteCaliReg(llHdl);
 
     /* perform a wait ( settling time) */
-    OSS_Delay(llHdl->osHdl, llHdl->settleTime);
+    Settle(llHdl);
 
-    bufP++;
-    error = ReadDataReg(llHdl, bufP, COM_DATA);
+    error = ReadDataReg(llHdl, &v[1], COM_DATA);
     if (error)
         return(error);
-    *bufP >>= 8;
-    *bufP &= 0x00ffffff;
+    v[1] = (v[1] >> 8) & 0x00ffffff;
 
     /* default R parameters (Ux) */
     llHdl->modGain = gain;          /* restore Ux gain */
@@ -1353,10 +2973,11 @@ static int32 M76_BlockRead(
     WriteModeReg(llHdl);
     WriteCaliReg(llHdl);
     /* perform a wait ( settling time) */
-    OSS_Delay(llHdl->osHdl, llHdl->settleTime);
+    Settle(llHdl);
 
-    /* return number of read bytes */
-    *nbrRdBytesP = 8;
+    /* format, packed samples need less than the two words */
+    *nbrRdBytesP = FmtWords(llHdl, v, 2);
+    OSS_MemCopy(llHdl->osHdl, *nbrRdBytesP, (char*)v, (char*)buf);
 
     return(ERR_SUCCESS);
 }
@@ -1408,16 +3029,24 @@ static int32 M76_Irq(
    LL_HANDLE *llHdl
 )
 {
-    IDBGWRT_1((DBH, ">>> M76_Irq:\n"));
+    u_int16 stat = MREAD_D16(llHdl->ma, STAT_REG);
 
-    if ( (MREAD_D16(llHdl->ma, STAT_REG) & IRQ_PEND) == 0 )  
+    if ( (stat & IRQ_PEND) == 0 )  
         return(LL_IRQ_DEV_NOT);         /* not my interrupt */
 
     MWRITE_D16(llHdl->ma, ACCESS_REG, 0);   
                                             
-    OSS_SemSignal(llHdl->osHdl, llHdl->readSem);
-            
     llHdl->irqCount++;
+    llHdl->irqTime = M76_EVT_TIME(llHdl);
+    llHdl->acq.irqs++;
+    EVT(llHdl, M76_EV_IRQ, stat, llHdl->irqCount);
+
+    if (llHdl->nbPending && (llHdl->nbOn == M76_NBLOCK_LATEST))
+        NbFetch(llHdl);                 /* fetch and start next */
+    else
+        OSS_SemSignal(llHdl->osHdl, llHdl->readSem);
+    if (llHdl->nbPending && llHdl->rdySig)
+        OSS_SigSend(llHdl->osHdl, llHdl->rdySig);
 
     return(LL_IRQ_DEVICE);      
 }
@@ -1585,6 +3214,21 @@ static int32 Cleanup(
     if (llHdl->readSem)
         OSS_SemRemove( llHdl->osHdl, &llHdl->readSem );
 
+    if (llHdl->jobAlarm)
+        OSS_AlarmRemove( llHdl->osHdl, &llHdl->jobAlarm );
+
+    if (llHdl->almSig)
+        OSS_SigRemove( llHdl->osHdl, &llHdl->almSig );
+
+    if (llHdl->rdySig)
+        OSS_SigRemove( llHdl->osHdl, &llHdl->rdySig );
+
+    if (llHdl->paceAlarm)
+        OSS_AlarmRemove( llHdl->osHdl, &llHdl->paceAlarm );
+
+    if (llHdl->paceBuf)
+        OSS_MemFree( llHdl->osHdl, (int8*)llHdl->paceBuf, llHdl->paceAlloc );
+
     if( llHdl->mcrwHdl )
         llHdl->mcrwHdl->Exit( (void **)&llHdl->mcrwHdl );
     
@@ -1671,6 +3315,288 @@ static int32 MakeMwHandle( LL_HANDLE *llHdl )/* nodoc */
 }
 
 
+/********************************* SetRange *********************************
+ *
+ *  Description: Select measurement range.
+ *               Write Config/Filter/Mode Registers and calibration values
+ *               of the range to the ADC and wait settling time.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle
+ *               range      M76_RANGE_xxx
+ *  Output.....: return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 SetRange(LL_HANDLE *llHdl, int32 range)   /* nodoc */
+{
+    int32 error = ERR_SUCCESS;
+    u_int32 oldRange = llHdl->range;
+    USER_RANGE *u;
+
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_SETRANGE);
+
+    switch(range) {
+    case M76_RANGE_DC_V0:
+        llHdl->conMode = DC_V0;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_DC_V1:
+        llHdl->conMode = DC_V1;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_DC_V2:
+        llHdl->conMode = DC_V2;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_DC_V3:
+        llHdl->conMode = DC_V3;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_DC_V4:
+        llHdl->conMode = DC_V4;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_AC_V0:
+        llHdl->conMode = AC_V0;
+        llHdl->comChan = COM_AC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_AC_V1:
+        llHdl->conMode = AC_V1;
+        llHdl->comChan = COM_AC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_AC_V2:
+        llHdl->conMode = AC_V2;
+        llHdl->comChan = COM_AC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_AC_V3:
+        llHdl->conMode = AC_V3;
+        llHdl->comChan = COM_AC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_DC_A0:
+        llHdl->conMode = DC_A0;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_DC_A1:
+        llHdl->conMode = DC_A1;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_DC_A2:
+        llHdl->conMode = DC_A2;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_DC_A3:
+        llHdl->conMode = DC_A3;
+        llHdl->comChan = COM_DC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_BI;
+        break;
+
+    case M76_RANGE_AC_A0:
+        llHdl->conMode = AC_A0;
+        llHdl->comChan = COM_AC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_AC_A1:
+        llHdl->conMode = AC_A1;
+        llHdl->comChan = COM_AC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_AC_A2:
+        llHdl->conMode = AC_A2;
+        llHdl->comChan = COM_AC;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R2_0:
+        llHdl->conMode = R2_1;  
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_4; 
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R2_1:
+        llHdl->conMode = R2_1;
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R2_2:
+        llHdl->conMode = R2_2;
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R2_3:
+        llHdl->conMode = R2_3;
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R2_4:
+        llHdl->conMode = R2_4;
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R4_0:
+        llHdl->conMode = R4_1;   
+        llHdl->comChan = COM_R_U;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_4; 
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R4_1:
+        llHdl->conMode = R4_1;
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R4_2:
+        llHdl->conMode = R4_2;
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R4_3:
+        llHdl->conMode = R4_3;
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    case M76_RANGE_R4_4:
+        llHdl->conMode = R4_4;
+        llHdl->comChan = COM_R_U;  
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = MOD_GAIN_1;
+        llHdl->filPolarity = FHI_POLAR_UNI;
+        break;
+
+    default:        /* custom range preset */
+        if ((range < RANGE_NUM) || (range >= RANGE_MAX) ||
+            !llHdl->user[range - RANGE_NUM].defined)  {
+            error = ERR_LL_ILL_PARAM;
+            break;
+        }
+        u = &llHdl->user[range - RANGE_NUM];
+        llHdl->conMode = u->config;
+        llHdl->comChan = u->comChan;
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->modGain = u->modGain;
+        llHdl->filPolarity = u->polarity;
+        break;
+    }
+    if (!error)  {
+        /* restore filter/settle time overridden by the previous preset */
+        if (llHdl->userSaved & USER_SAV_FIL)
+            llHdl->filFilter = llHdl->userFilter;
+        if (llHdl->userSaved & USER_SAV_SET)
+            llHdl->settleTime = llHdl->userSettle;
+        llHdl->userSaved = 0;
+
+        if (range >= RANGE_NUM)  {
+            u = &llHdl->user[range - RANGE_NUM];
+            if (u->filter)  {
+                llHdl->userFilter = llHdl->filFilter;
+                llHdl->filFilter = u->filter;
+                llHdl->userSaved |= USER_SAV_FIL;
+            }
+            if (u->settle)  {
+                llHdl->userSettle = llHdl->settleTime;
+                llHdl->settleTime = u->settle;
+                llHdl->userSaved |= USER_SAV_SET;
+            }
+        }
+        llHdl->range = range;
+        EVT(llHdl, M76_EV_RANGE, range, oldRange);
+        WriteConfigReg(llHdl);
+        WriteFilterReg(llHdl);      
+        WriteModeReg(llHdl);
+        
+        WriteCaliRegUpd(llHdl);/* write new cali val to ADC,*/
+                               /*  update cali info */
+        Settle(llHdl);
+        EVT(llHdl, M76_EV_SETTLED, range, llHdl->settleTime);
+        llHdl->pfCnt = 0;           /* restart post-filter */
+        llHdl->statCur.count = 0;   /* restart statistics window */
+        llHdl->dbValid = FALSE;     /* report next value */
+    }
+    M76_TRC_LEAVE(llHdl->ma);
+    return(error);
+}
+
+
 /********************************* WriteConfigReg *****************************
  *
  *  Description: Write to Config Register.
@@ -1683,14 +3609,18 @@ static int32 WriteConfigReg(LL_HANDLE *llHdl)   /* nodoc */
 {
     u_int16 conH,conL;
 
+    NbCancel(llHdl);
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_CONFIG);
+
     conH = (u_int16)(llHdl->conMode >> 16);
     MWRITE_D16(llHdl->ma, CONFIG_REG, conH);    /* high word */
 
     conL = (u_int16)(llHdl->conMode & 0xffff);
     MWRITE_D16(llHdl->ma, CONFIG_REG+2, conL);  /* low word */
 
-    DBGWRT_2((DBH, "LL - WriteConfigReg: %x, %x\n",conH,conL));
+    EVT(llHdl, M76_EV_CONFIG, llHdl->conMode, 0);
 
+    M76_TRC_LEAVE(llHdl->ma);
     return (0);
 }
 
@@ -1707,14 +3637,18 @@ static int32 WriteModeReg(LL_HANDLE *llHdl) /* nodoc */
 {
     u_int16 com, mod;
 
+    NbCancel(llHdl);
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_MODE);
+
     com = (COM_MODE | llHdl->comChan);
     MWRITE_D16(llHdl->ma, COM_REG, com);
     
     mod = (llHdl->modMode | llHdl->modGain);
     MWRITE_D16(llHdl->ma, COM_REG, mod);
 
-    DBGWRT_2((DBH, "LL - WriteModeReg: %x, %x\n",com,mod));
+    EVT(llHdl, M76_EV_COM, com, mod);
 
+    M76_TRC_LEAVE(llHdl->ma);
     return(0);
 }
 
@@ -1731,14 +3665,18 @@ static int32 WriteFilterReg(LL_HANDLE *llHdl)   /* nodoc */
 {
     u_int16 com,fil;
     
+    NbCancel(llHdl);
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_FILTER);
+
     /* filter high */
     com = (COM_FILTER_HIGH | llHdl->comChan);
     MWRITE_D16(llHdl->ma, COM_REG, com);
     
-    fil = ( llHdl->filPolarity | FHI_WL | ((llHdl->filFilter>>8) & 0xf) );
+    fil = ( llHdl->filPolarity | (llHdl->fast ? 0 : FHI_WL) | 
+            ((llHdl->filFilter>>8) & 0xf) );
     MWRITE_D16(llHdl->ma, COM_REG, fil);
 
-    DBGWRT_2((DBH, "LL - WriteFilterReg high: %x, %x\n",com,fil));
+    EVT(llHdl, M76_EV_COM, com, fil);
 
     /* filter low */
     com = (COM_FILTER_LOW | llHdl->comChan);
@@ -1747,8 +3685,9 @@ static int32 WriteFilterReg(LL_HANDLE *llHdl)   /* nodoc */
     fil = (llHdl->filFilter & 0xff);
     MWRITE_D16(llHdl->ma, COM_REG, fil);
 
-    DBGWRT_2((DBH, "LL - WriteFilterReg low: %x, %x\n",com,fil));
+    EVT(llHdl, M76_EV_COM, com, fil);
 
+    M76_TRC_LEAVE(llHdl->ma);
     return(0);
 }
 
@@ -1775,42 +3714,20 @@ static int32 CalibAdc(LL_HANDLE *llHdl, int32 *val) /* nodoc */
 
     DBGWRT_2((DBH, "LL - CalibAdc val: %x\n",*val));
     
-    if (*val < 0)
-        return(ERR_LL_ILL_PARAM);
-    if (*val > 5)
-        return(ERR_LL_ILL_PARAM);
-    if ( (*val < 2) && (llHdl->range > M76_RANGE_AC_A2) )
-        return(ERR_LL_ILL_PARAM);
-    if ( (*val > 1) && (llHdl->range < M76_RANGE_R2_0) )
+    if (CheckCaliKind(llHdl->range, *val))
         return(ERR_LL_ILL_PARAM);
 
     /* detect cali values for range */
-    if (llHdl->range < M76_RANGE_R2_0)  {  /* AC + DC calibration */
+    if (!RANGE_IS_R(llHdl->range))  {  /* AC + DC calibration */
         switch (*val)  {
         case 0: /* cali zero-scale */
             /* initiate calibration */
-            llHdl->modMode = MOD_ZERO;
-            WriteModeReg(llHdl);
-            llHdl->modMode = MOD_NORMAL;
-
-            OSS_Delay(llHdl->osHdl, 1);     /* wait at least one modulator cycle */ 
-            
-            error = ReadDataReg(llHdl, val, COM_DATA);
-            if (error == 0)
-                error = ReadDataReg(llHdl, val, COM_CALI_ZERO);
+            error = CalibConv(llHdl, MOD_ZERO, COM_CALI_ZERO, val);
             break;
         
         case 1: /* cali full-scale */
             /* initiate calibration */
-            llHdl->modMode = MOD_FULL;
-            WriteModeReg(llHdl);
-            llHdl->modMode = MOD_NORMAL;
-
-            OSS_Delay(llHdl->osHdl, 1);     /* wait at least one modulator cycle */ 
-            
-            error = ReadDataReg(llHdl, val, COM_DATA);
-            if (error == 0)
-                error = ReadDataReg(llHdl, val, COM_CALI_FULL);
+            error = CalibConv(llHdl, MOD_FULL, COM_CALI_FULL, val);
             break;
         default:
             error = ERR_LL_ILL_PARAM;
@@ -1829,17 +3746,10 @@ static int32 CalibAdc(LL_HANDLE *llHdl, int32 *val) /* nodoc */
             /* perform some normal conversions for a time */
             WriteFilterReg(llHdl);
             WriteModeReg(llHdl);  
-            OSS_Delay(llHdl->osHdl, llHdl->settleTime); /* channel changed */
+            Settle(llHdl); /* channel changed */
 
             /* initiate calibration */
-            llHdl->modMode = MOD_ZERO;
-            WriteModeReg(llHdl);            
-
-            OSS_Delay(llHdl->osHdl, 1);     /* wait at least one modulator cycle */ 
-            
-            error = ReadDataReg(llHdl, val, COM_DATA);
-            if (error == 0)
-                error = ReadDataReg(llHdl, val, COM_CALI_ZERO );
+            error = CalibConv(llHdl, MOD_ZERO, COM_CALI_ZERO, val);
 
             /* restore Ux settings in llHdl */
             llHdl->modMode = MOD_NORMAL;    
@@ -1850,7 +3760,7 @@ static int32 CalibAdc(LL_HANDLE *llHdl, int32 *val) /* nodoc */
             WriteFilterReg(llHdl);
             WriteModeReg(llHdl);  
             WriteCaliReg(llHdl);
-            OSS_Delay(llHdl->osHdl, llHdl->settleTime);
+            Settle(llHdl);
             break;
             }
 
@@ -1865,17 +3775,10 @@ static int32 CalibAdc(LL_HANDLE *llHdl, int32 *val) /* nodoc */
             WriteFilterReg(llHdl);
             WriteModeReg(llHdl);  
             WriteCaliReg(llHdl);    /* write Im zero-scale calibration val */
-            OSS_Delay(llHdl->osHdl, llHdl->settleTime); /* channel changed */
+            Settle(llHdl); /* channel changed */
 
             /* initiate calibration */
-            llHdl->modMode = MOD_FULL;
-            WriteModeReg(llHdl);            
-
-            OSS_Delay(llHdl->osHdl, 1);     /* wait at least one modulator cycle */ 
-            
-            error = ReadDataReg(llHdl, val, COM_DATA);
-            if (error == 0)
-                error = ReadDataReg(llHdl, val, COM_CALI_FULL );
+            error = CalibConv(llHdl, MOD_FULL, COM_CALI_FULL, val);
 
             /* restore Ux settings in llHdl */
             llHdl->modMode = MOD_NORMAL;    
@@ -1886,34 +3789,18 @@ static int32 CalibAdc(LL_HANDLE *llHdl, int32 *val) /* nodoc */
             WriteFilterReg(llHdl);
             WriteModeReg(llHdl);  
             WriteCaliReg(llHdl);
-            OSS_Delay(llHdl->osHdl, llHdl->settleTime);
+            Settle(llHdl);
             break;
             }
 
         case 2: /* Ux cali zero-scale */
             /* initiate calibration */
-            llHdl->modMode = MOD_ZERO;
-            WriteModeReg(llHdl);
-            llHdl->modMode = MOD_NORMAL;
-
-            OSS_Delay(llHdl->osHdl, 1);     /* wait at least one modulator cycle */ 
-            
-            error = ReadDataReg(llHdl, val, COM_DATA);
-            if (error == 0)
-                error = ReadDataReg(llHdl, val, COM_CALI_ZERO );
+            error = CalibConv(llHdl, MOD_ZERO, COM_CALI_ZERO, val);
             break;
 
         case 5: /* Ux cali full-scale */
             /* initiate calibration */
-            llHdl->modMode = MOD_FULL;
-            WriteModeReg(llHdl);
-            llHdl->modMode = MOD_NORMAL;
-
-            OSS_Delay(llHdl->osHdl, 1);     /* wait at least one modulator cycle */ 
-            
-            error = ReadDataReg(llHdl, val, COM_DATA);
-            if (error == 0)
-                error = ReadDataReg(llHdl, val, COM_CALI_FULL );
+            error = CalibConv(llHdl, MOD_FULL, COM_CALI_FULL, val);
             break;
         default:
             error = ERR_LL_ILL_PARAM;
@@ -1924,54 +3811,242 @@ static int32 CalibAdc(LL_HANDLE *llHdl, int32 *val) /* nodoc */
 }
 
 
-/********************************* WriteCaliVal *****************************
+/********************************* CheckCaliKind ****************************
  *
- *  Description: Write a value to calibration memory for current range.
+ *  Description: Check if kind of calibration value fits to range. 
  *---------------------------------------------------------------------------
- *  Input......: llHdl  low-level handle
- *               mode   0 = zero-scale AC/DC voltage/current
- *                      1 = full-scale AC/DC voltage/current
- *                      2 = Ux zero-scale resistance
- *                      3 = Im full-scale resistance
- *                      4 = Im zero-scale resistance
- *                      5 = Ux full-scale resistance
- *               val  value to be written 
- *  Output.....: return     success (0) or error code
- *               llHdl      calib value in llHdl for range and val
- *               val        calib value vor range and val
+ *  Input......: range  M76_RANGE_xxx
+ *               kind   kind of calibration value 0..5 (see CalibAdc)
+ *  Output.....: return 0 if ok, else ERR_LL_ILL_PARAM
  *  Globals....: -
  ****************************************************************************/
-static int32 WriteCaliVal(LL_HANDLE *llHdl, u_int32 mode, u_int32 val)/* nodoc */
+static int32 CheckCaliKind(u_int32 range, int32 kind)   /* nodoc */
 {
-    CALI_VA *va;
-    CALI_R  *r;
-    u_int32 i;
-    
-    DBGWRT_2((DBH, "LL - WriteCaliVal mode: %x  val: %x\n",mode,val));
-
-    if (mode > 5)
+    if ( (kind < 0) || (kind > 5) )
         return(ERR_LL_ILL_PARAM);
-    if ( (mode < 2) && (llHdl->range > M76_RANGE_AC_A2) )
+    if ( (kind < 2) && RANGE_IS_R(range) )
         return(ERR_LL_ILL_PARAM);
-    if ( (mode > 1) && (llHdl->range < M76_RANGE_R2_0) )
+    if ( (kind > 1) && !RANGE_IS_R(range) )
         return(ERR_LL_ILL_PARAM);
 
-    if ( ((val & 0xffff0000) == 0xffff0000)  ||
-         ((val & 0x0000ffff) == 0x0000ffff) )
-        return(ERR_LL_ILL_PARAM);
+    return(0);
+}
 
-    /* detect cali values for range */
-    if (llHdl->range < M76_RANGE_R2_0)  {  /* AC + DC calibration */
-        va = &llHdl->caliVals.dcV[0];
-    
-        for(i=M76_RANGE_DC_V0; i<llHdl->range; i++, va++); /* go to start of current */
-                                                       /* calib parameters */   
-        switch (mode)  {
-        case 0: /* cali zero-scale */
-            va->zero = val;
-            break;
-        
-        case 1: /* cali full-scale */
+/********************************* CalibConv ********************************
+ *
+ *  Description: Perform a zero- or full-scale calibration conversion for 
+ *               the current ADC channel and read the resulting value from 
+ *               the ADC's Calibration Register.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl  low-level handle
+ *               mode   MOD_ZERO or MOD_FULL
+ *               reg    COM_CALI_ZERO or COM_CALI_FULL
+ *  Output.....: val    calib value
+ *               return success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 CalibConv(LL_HANDLE *llHdl, u_int16 mode, int32 reg, int32 *val) /* nodoc */
+{
+    int32 error;
+
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_CALCONV);
+
+    llHdl->modMode = mode;
+    WriteModeReg(llHdl);
+    llHdl->modMode = MOD_NORMAL;
+
+    OSS_Delay(llHdl->osHdl, 1);     /* wait at least one modulator cycle */ 
+    
+    error = ReadDataReg(llHdl, val, COM_DATA);
+    if (error == 0)
+        error = ReadDataReg(llHdl, val, reg);
+
+    M76_TRC_LEAVE(llHdl->ma);
+    return(error);
+}
+
+/* execution order of calibration kinds within a range (Ux before Im) */
+static const u_int8 G_caliKindOrder[6] = { 0, 1, 0, 3, 2, 1 };
+
+/********************************* CalibJob *********************************
+ *
+ *  Description: Perform a list of calibrations (M76_BLK_CALI_JOB).
+ *
+ *               The steps are sorted by range (current range first) and
+ *               by kind (zero before full, Ux before Im), so every range is
+ *               selected only once and the Im channel is selected only once
+ *               per range. Detected values are written to calibration 
+ *               memory. At the end the previous range is restored.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl  low-level handle
+ *               job    calibration job
+ *  Output.....: job    values, error codes, nFailed, stored
+ *               return success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 CalibJob(LL_HANDLE *llHdl, M76_CALI_JOB *job)  /* nodoc */
+{
+    u_int8 order[M76_CALI_JOB_MAX];
+    M76_CALI_STEP *st;
+    u_int32 n = job->nSteps, i, j, k, key, oldRange = llHdl->range;
+    u_int32 range, imSel;
+    u_int16 gain = 0;
+    int32 error = 0;
+
+    DBGWRT_2((DBH, "LL - CalibJob: nSteps=%d flags=%x\n",n,job->flags));
+
+    if ((n == 0) || (n > M76_CALI_JOB_MAX))
+        return(ERR_LL_ILL_PARAM);
+
+    /* check steps */
+    for (i=0; i<n; i++)  {
+        st = &job->step[i];
+        if ( (st->range >= RANGE_MAX) || (st->kind > 5) ||
+             CheckCaliKind(st->range, st->kind) )
+            return(ERR_LL_ILL_PARAM);
+        st->value = 0;
+        st->error = 0;
+    }
+
+    /* sort steps by range (current range first) and kind */
+#define _STEP_KEY(s) ((((s)->range == oldRange) ? 0 : ((s)->range+1)) * 8 + \
+                      G_caliKindOrder[(s)->kind])
+    for (i=0; i<n; i++)  {
+        key = _STEP_KEY(&job->step[i]);
+        for (j=i; (j>0) && (_STEP_KEY(&job->step[order[j-1]]) > key); j--)
+            order[j] = order[j-1];
+        order[j] = (u_int8)i;
+    }
+#undef _STEP_KEY
+
+    job->nFailed = 0;
+    job->stored  = FALSE;
+
+    for (i=0; i<n; i=j)  {
+        range = job->step[order[i]].range;
+
+        /* end of range group */
+        for (j=i; (j<n) && (job->step[order[j]].range == range); j++)
+            ;
+
+        if (range != llHdl->range)  {
+            if ((error = SetRange(llHdl, range)))  {
+                for (k=i; k<j; k++)
+                    job->step[order[k]].error = error;
+                job->nFailed += j-i;
+                continue;
+            }
+        }
+
+        imSel = FALSE;
+        for (k=i; k<j; k++)  {
+            st = &job->step[order[k]];
+
+            /* select Im channel once for all Im steps of range */
+            if (((st->kind == 3) || (st->kind == 4)) && !imSel)  {
+                gain = llHdl->modGain;  /* store gain for Ux */
+                llHdl->modGain = MOD_GAIN_1;
+                llHdl->comChan = COM_R_I;
+                WriteFilterReg(llHdl);
+                WriteModeReg(llHdl);
+                WriteCaliReg(llHdl);
+                Settle(llHdl); /* channel changed */
+                imSel = TRUE;
+            }
+
+            /* kinds 0,2,4: zero-scale, 1,3,5: full-scale */
+            if ((st->kind == 0) || (st->kind == 2) || (st->kind == 4))
+                st->error = CalibConv(llHdl, MOD_ZERO, COM_CALI_ZERO, &st->value);
+            else
+                st->error = CalibConv(llHdl, MOD_FULL, COM_CALI_FULL, &st->value);
+
+            if (st->error == 0)
+                st->error = WriteCaliVal(llHdl, st->kind, st->value);
+
+            if (st->error)
+                job->nFailed++;
+            else
+                llHdl->caliDirty |= CALI_DIRTY(range);
+        }
+
+        if (imSel)  {
+            /* set ADC to default R parameters (Ux) */
+            llHdl->comChan = COM_R_U;
+            llHdl->modGain = gain;
+            WriteFilterReg(llHdl);
+            WriteModeReg(llHdl);
+            WriteCaliReg(llHdl);
+            Settle(llHdl);
+        }
+        WriteCaliRegUpd(llHdl);/* write new cali val to ADC,*/
+                               /*  update cali info */
+    }
+
+    /* restore range */
+    if (llHdl->range != oldRange)
+        error = SetRange(llHdl, oldRange);
+
+    /* store calibration memory */
+    if ((job->flags & M76_CALI_JOB_STORE) && (job->nFailed == 0) && !error)  {
+        if ((error = WriteCaliProm(llHdl)) == 0)  {
+            /* valid checksum */
+            llHdl->checkSum = TRUE;
+            llHdl->permitMeas = TRUE;
+            llHdl->caliSrc = M76_CALI_SRC_EEPROM;
+            llHdl->caliDirty = 0;
+            job->stored = TRUE;
+        }
+    }
+
+    return(error);
+}
+
+
+/********************************* WriteCaliVal *****************************
+ *
+ *  Description: Write a value to calibration memory for current range.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl  low-level handle
+ *               mode   0 = zero-scale AC/DC voltage/current
+ *                      1 = full-scale AC/DC voltage/current
+ *                      2 = Ux zero-scale resistance
+ *                      3 = Im full-scale resistance
+ *                      4 = Im zero-scale resistance
+ *                      5 = Ux full-scale resistance
+ *               val  value to be written 
+ *  Output.....: return     success (0) or error code
+ *               llHdl      calib value in llHdl for range and val
+ *               val        calib value vor range and val
+ *  Globals....: -
+ ****************************************************************************/
+static int32 WriteCaliVal(LL_HANDLE *llHdl, u_int32 mode, u_int32 val)/* nodoc */
+{
+    CALI_VA *va;
+    CALI_R  *r;
+    u_int32 i;
+    
+    DBGWRT_2((DBH, "LL - WriteCaliVal mode: %x  val: %x\n",mode,val));
+
+    if (mode > 5)
+        return(ERR_LL_ILL_PARAM);
+    if ( (mode < 2) && RANGE_IS_R(llHdl->range) )
+        return(ERR_LL_ILL_PARAM);
+    if ( (mode > 1) && !RANGE_IS_R(llHdl->range) )
+        return(ERR_LL_ILL_PARAM);
+
+    if ( ((val & 0xffff0000) == 0xffff0000)  ||
+         ((val & 0x0000ffff) == 0x0000ffff) )
+        return(ERR_LL_ILL_PARAM);
+
+    /* detect cali values for range */
+    if (!RANGE_IS_R(llHdl->range))  {  /* AC + DC calibration */
+        va = CaliVa(llHdl);         /* built-in range or custom preset */
+        switch (mode)  {
+        case 0: /* cali zero-scale */
+            va->zero = val;
+            break;
+        
+        case 1: /* cali full-scale */
             va->full = val;
             break;
         default:
@@ -2026,12 +4101,12 @@ static int32 WriteCaliReg(LL_HANDLE *llHdl) /* nodoc */
     int32 error=0;
     u_int16 com, calH, calL;
 
+    NbCancel(llHdl);
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_CALIREG);
+
     /* get cali values for range */
-    if (llHdl->range < M76_RANGE_R2_0)  {  /* AC + DC measurement */
-        va = &llHdl->caliVals.dcV[0];
-    
-        for(i=M76_RANGE_DC_V0; i<llHdl->range; i++, va++); /* go to start of current */
-                                                       /* calib parameters */   
+    if (!RANGE_IS_R(llHdl->range))  {  /* AC + DC measurement */
+        va = CaliVa(llHdl);         /* built-in range or custom preset */
         /*----------------+
         | cali zero-scale |
         +----------------*/
@@ -2045,7 +4120,7 @@ static int32 WriteCaliReg(LL_HANDLE *llHdl) /* nodoc */
         /* check validity*/
         if ((calH==0xffff) || (calL==0xffff))  
             error = ERR_LL_ILL_PARAM;
-        DBGWRT_2((DBH, "LL - WriteCaliReg zero (V/A): %x %x %x\n",com,calH,calL));
+        EVT(llHdl, M76_EV_COM, com, ((u_int32)calH << 16) | calL);
 
         /*----------------+
         | cali full-scale |
@@ -2060,7 +4135,7 @@ static int32 WriteCaliReg(LL_HANDLE *llHdl) /* nodoc */
         /* check validity*/
         if ((calH==0xffff) || (calL==0xffff))
             error = ERR_LL_ILL_PARAM;
-        DBGWRT_2((DBH, "LL - WriteCaliReg full (V/A): %x %x %x\n",com,calH,calL));
+        EVT(llHdl, M76_EV_COM, com, ((u_int32)calH << 16) | calL);
 
     }
     else  {         /* R measurement */
@@ -2084,7 +4159,7 @@ static int32 WriteCaliReg(LL_HANDLE *llHdl) /* nodoc */
             if ((calH==0xffff) || (calL==0xffff))
                 error = ERR_LL_ILL_PARAM;
 
-            DBGWRT_2((DBH, "LL - WriteCaliReg zero (R,Im): %x %x %x\n",com,calH,calL));
+            EVT(llHdl, M76_EV_COM, com, ((u_int32)calH << 16) | calL);
 
             /*--------------------+
             | cali Im, full-scale |
@@ -2100,7 +4175,7 @@ static int32 WriteCaliReg(LL_HANDLE *llHdl) /* nodoc */
             if ((calH==0xffff) || (calL==0xffff))
                 error = ERR_LL_ILL_PARAM;
 
-            DBGWRT_2((DBH, "LL - WriteCaliReg full (R,Im): %x %x %x\n",com,calH,calL));
+            EVT(llHdl, M76_EV_COM, com, ((u_int32)calH << 16) | calL);
         }
         else  {
             /*--------------------+
@@ -2117,7 +4192,7 @@ static int32 WriteCaliReg(LL_HANDLE *llHdl) /* nodoc */
             if ((calH==0xffff) || (calL==0xffff))
                 error = ERR_LL_ILL_PARAM;
 
-            DBGWRT_2((DBH, "LL - WriteCaliReg zero (R,Ux): %x %x %x\n",com,calH,calL));
+            EVT(llHdl, M76_EV_COM, com, ((u_int32)calH << 16) | calL);
             /*--------------------+
             | cali Ux, full-scale |
             +--------------------*/
@@ -2132,10 +4207,11 @@ static int32 WriteCaliReg(LL_HANDLE *llHdl) /* nodoc */
             if ((calH==0xffff) || (calL==0xffff))
                 error = ERR_LL_ILL_PARAM;
 
-            DBGWRT_2((DBH, "LL - WriteCaliReg full (R,Ux): %x %x %x\n",com,calH,calL));
+            EVT(llHdl, M76_EV_COM, com, ((u_int32)calH << 16) | calL);
         }
         
     }
+    M76_TRC_LEAVE(llHdl->ma);
     return(error);
 }
 
@@ -2154,7 +4230,7 @@ static int32 WriteCaliReg(LL_HANDLE *llHdl) /* nodoc */
 static int32 WriteCaliRegUpd(LL_HANDLE *llHdl)  /* nodoc */
 {
     /* if range = R check validity of calibration vals for Im and Ux*/
-    if (llHdl->range > M76_RANGE_AC_A2)  {
+    if (RANGE_IS_R(llHdl->range))  {
         u_int32 help;
         /* check Im calibration vals */
         llHdl->comChan = COM_R_I;
@@ -2187,6 +4263,288 @@ static int32 WriteCaliRegUpd(LL_HANDLE *llHdl)  /* nodoc */
     return(0);
 }
 
+/********************************* LoadCaliVals *****************************
+ *
+ *  Description: Load calibration memory according to CALI_POLICY.
+ *
+ *               Whenever the user EEPROM is used, its magic word is checked
+ *               first. If there is no magic word then all cells used for 
+ *               calibration values are set to 0xffff.
+ *
+ *               A CALI_BLOB with wrong size, header or checksum is ignored.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle
+ *  Output.....: llHdl->caliVals   calibration memory
+ *               return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 LoadCaliVals(LL_HANDLE *llHdl) /* nodoc */
+{
+    int32 error=0;
+    u_int8 *blob = NULL;
+    u_int32 blobLen = M76_CALI_BLOB_SIZE, gotsize = 0, blobOk = FALSE;
+
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_LOADCALI);
+
+    DBGWRT_2((DBH, "LL - LoadCaliVals: policy=%d\n",llHdl->caliPolicy));
+
+    /*------------------------------+
+    |  calibration image            |
+    +------------------------------*/
+    if (llHdl->caliPolicy != M76_CALI_POL_EEPROM)  {
+        if ((blob = (u_int8*)OSS_MemGet(
+                        llHdl->osHdl, M76_CALI_BLOB_SIZE, &gotsize)) == NULL)  {
+            M76_TRC_LEAVE(llHdl->ma);
+            return(ERR_OSS_MEM_ALLOC);
+        }
+
+        error = DESC_GetBinary(llHdl->descHdl, (u_int8*)"", 0,
+                               blob, &blobLen, "CALI_BLOB");
+        if (error == 0)  {
+            if ((blobLen != M76_CALI_BLOB_SIZE) || CheckCaliBlob(blob))  {
+                DBGWRT_ERR((DBH," *** LoadCaliVals: invalid CALI_BLOB\n"));
+            }
+            else  {
+                blobOk = TRUE;
+            }
+        }
+        else if (error == ERR_DESC_BUF_TOOSMALL)  {
+            DBGWRT_ERR((DBH," *** LoadCaliVals: CALI_BLOB too long\n"));
+        }
+        else if (error != ERR_DESC_KEY_NOTFOUND)  {
+            OSS_MemFree(llHdl->osHdl, (int8*)blob, gotsize);
+            M76_TRC_LEAVE(llHdl->ma);
+            return(error);
+        }
+        error = 0;
+
+        /* skip user EEPROM */
+        if ((llHdl->caliPolicy == M76_CALI_POL_BLOB) && blobOk)  {
+            CaliBlobToMem(llHdl, blob);
+            llHdl->caliSrc = M76_CALI_SRC_BLOB;
+            llHdl->checkSum = TRUE;
+            llHdl->permitMeas = TRUE;
+            OSS_MemFree(llHdl->osHdl, (int8*)blob, gotsize);
+            M76_TRC_LEAVE(llHdl->ma);
+            return(0);
+        }
+    }
+
+    /*------------------------------+
+    |  user EEPROM                  |
+    +------------------------------*/
+    /* check magic word of user EEPROM */
+    /* if there is no magic word in user EEPROM then set all cells used for */
+    /* calibration values to 0xffff */
+    MWRITE_D16(llHdl->ma, CTRL_REG, UEPROM_SEL);    /* select user EEPROM */
+    if ( __M76_UeeRead(llHdl->osHdl, llHdl->ma,
+             (u_int8)UEE_MAGIC_ADDRESS) != UEE_MAGIC )  
+    {
+        u_int16 idx;
+    
+        DBGWRT_2((DBH, " No UEE_MAGIC -> Set all uee calibration cells to 0xffff\n"));
+
+        for (idx=0; idx < (sizeof(llHdl->caliVals)/2+1); idx++)  {
+            error = UeeWrite(llHdl,(u_int8)idx, 0xffff);
+            if (error)  {
+                break;
+            }
+        }
+        /* write MAGIC */
+        if (error == 0)  {
+            error = UeeWrite(llHdl,(u_int8)UEE_MAGIC_ADDRESS,(u_int16)UEE_MAGIC);
+        }
+    }   
+    MWRITE_D16(llHdl->ma, CTRL_REG, IDPROM_SEL);    /* deselect user EEPROM */
+    if (error)  {       /* error deleting uee */
+        if (blob)
+            OSS_MemFree(llHdl->osHdl, (int8*)blob, gotsize);
+        M76_TRC_LEAVE(llHdl->ma);
+        return(error);
+    }
+    
+    /* read calibration EEPROM */
+    llHdl->caliSrc = M76_CALI_SRC_EEPROM;
+    if ( ReadCaliProm(llHdl) )  {
+        /* invalid checksum */
+        llHdl->checkSum = FALSE;    
+        llHdl->permitMeas = FALSE;
+    }
+    else  {
+        /* valid checksum */
+        llHdl->checkSum = TRUE;
+        llHdl->permitMeas = TRUE;
+    }
+
+    /*------------------------------+
+    |  compare / fallback           |
+    +------------------------------*/
+    if (blobOk)  {
+        if (llHdl->checkSum == FALSE)  {
+            llHdl->caliSrc = M76_CALI_SRC_BLOB;
+        }
+        else if (CmpCaliBlob(llHdl, blob))  {
+            DBGWRT_ERR((DBH," *** LoadCaliVals: CALI_BLOB differs from "
+                        "user EEPROM\n"));
+            llHdl->caliSrc = M76_CALI_SRC_DIFF;
+        }
+        if (llHdl->caliSrc != M76_CALI_SRC_EEPROM)  {
+            CaliBlobToMem(llHdl, blob);
+            llHdl->checkSum = TRUE;
+            llHdl->permitMeas = TRUE;
+        }
+    }
+
+    if (blob)
+        OSS_MemFree(llHdl->osHdl, (int8*)blob, gotsize);
+
+    M76_TRC_LEAVE(llHdl->ma);
+    return(0);
+}
+
+/* get 16-bit word <idx> of calibration image (stored MSB first) */
+#define CALI_BLOB_WORD(blob,idx) \
+    ((u_int16)(((u_int16)(blob)[2*(idx)] << 8) | (blob)[2*(idx)+1]))
+
+/* get calibration word <idx> of calibration image (after header) */
+#define CALI_BLOB_DATA(blob,idx) \
+    CALI_BLOB_WORD(blob, M76_CALI_BLOB_HDR+(idx))
+
+/* get range of 32-bit value <idx> in calibration memory */
+#define CALI_IDX_RANGE(idx) \
+    ((idx) < 32 ? (idx)/2 : M76_RANGE_R2_0 + ((idx)-32)/4)
+
+/********************************* CheckCaliBlob ****************************
+ *
+ *  Description: Check header of a calibration image and compare its words
+ *               with its checksum. (same XOR checksum as in user EEPROM)
+ *---------------------------------------------------------------------------
+ *  Input......: blob       calibration image (M76_CALI_BLOB_SIZE bytes)
+ *  Output.....: return     success (0) or error code if invalid header or
+ *                          checksum
+ *  Globals....: -
+ ****************************************************************************/
+static int32 CheckCaliBlob(u_int8 *blob)    /* nodoc */
+{
+    u_int16 idx, checkSum = 0;
+
+    if ((CALI_BLOB_WORD(blob, 0) != M76_CALI_BLOB_MAGIC) ||
+        (CALI_BLOB_WORD(blob, 1) != M76_CALI_BLOB_VERSION) ||
+        (CALI_BLOB_WORD(blob, 2) != M76_CALI_WORDS))
+        return(ERR_LL_ILL_PARAM);
+
+    for (idx=0; idx < M76_CALI_WORDS; idx++)
+        checkSum ^= CALI_BLOB_DATA(blob, idx);
+
+    if (checkSum != CALI_BLOB_DATA(blob, M76_CALI_WORDS))
+        return(ERR_LL_ILL_PARAM);
+
+    return(0);
+}
+
+/********************************* CaliBlobToMem ****************************
+ *
+ *  Description: Copy calibration image to calibration memory.
+ *               The image must have been checked with CheckCaliBlob().
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle
+ *               blob       calibration image
+ *  Output.....: llHdl->caliVals   calibration memory
+ *               return     changed ranges (bit n = range n)
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 CaliBlobToMem(LL_HANDLE *llHdl, u_int8 *blob)    /* nodoc */
+{
+    int32 *vals = (int32*)&llHdl->caliVals;
+    u_int32 idx, val, changed = 0;
+
+    for (idx=0; idx < M76_CALI_WORDS/2; idx++, vals++)  {
+        val = CALI_BLOB_DATA(blob, 2*idx) |
+              ((u_int32)CALI_BLOB_DATA(blob, 2*idx+1) << 16);
+        if ((u_int32)*vals != val)
+            changed |= (1 << CALI_IDX_RANGE(idx));
+        *vals = val;
+    }
+    return(changed);
+}
+
+/********************************* CaliMemToBlob ****************************
+ *
+ *  Description: Copy calibration memory to calibration image.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle
+ *  Output.....: blob       calibration image (M76_CALI_BLOB_SIZE bytes)
+ *  Globals....: -
+ ****************************************************************************/
+static void CaliMemToBlob(LL_HANDLE *llHdl, u_int8 *blob)   /* nodoc */
+{
+    int32 *vals = (int32*)&llHdl->caliVals;
+    u_int32 idx;
+    u_int16 word;
+
+    /* header */
+    blob[0] = (u_int8)(M76_CALI_BLOB_MAGIC >> 8);
+    blob[1] = (u_int8)M76_CALI_BLOB_MAGIC;
+    blob[2] = (u_int8)(M76_CALI_BLOB_VERSION >> 8);
+    blob[3] = (u_int8)M76_CALI_BLOB_VERSION;
+    blob[4] = (u_int8)(M76_CALI_WORDS >> 8);
+    blob[5] = (u_int8)M76_CALI_WORDS;
+    blob += 2*M76_CALI_BLOB_HDR;
+
+    for (idx=0; idx < M76_CALI_WORDS; idx++)  {
+        word = (u_int16)((idx & 1) ? ((u_int32)vals[idx/2] >> 16) : 
+                                     ((u_int32)vals[idx/2] & 0xffff));
+        blob[2*idx]   = (u_int8)(word >> 8);
+        blob[2*idx+1] = (u_int8)word;
+    }
+    word = CaliChecksum(vals);
+    blob[2*M76_CALI_WORDS]   = (u_int8)(word >> 8);
+    blob[2*M76_CALI_WORDS+1] = (u_int8)word;
+}
+
+/********************************* CaliChecksum *****************************
+ *
+ *  Description: Build XORed checksum of calibration values.
+ *               (same checksum as in user EEPROM)
+ *---------------------------------------------------------------------------
+ *  Input......: vals       calibration values (M76_CALI_WORDS/2)
+ *  Output.....: return     checksum
+ *  Globals....: -
+ ****************************************************************************/
+static u_int16 CaliChecksum(int32 *vals)    /* nodoc */
+{
+    u_int32 idx;
+    u_int16 checkSum = 0;
+
+    for (idx=0; idx < M76_CALI_WORDS/2; idx++)  {
+        checkSum ^= (u_int16)(vals[idx] & 0xffff);
+        checkSum ^= (u_int16)((vals[idx] >> 16) & 0xffff);
+    }
+    return(checkSum);
+}
+
+/********************************* CmpCaliBlob ******************************
+ *
+ *  Description: Compare calibration image with calibration memory.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle
+ *               blob       calibration image
+ *  Output.....: return     0 if equal, 1 if different
+ *  Globals....: -
+ ****************************************************************************/
+static int32 CmpCaliBlob(LL_HANDLE *llHdl, u_int8 *blob)    /* nodoc */
+{
+    int32 *vals = (int32*)&llHdl->caliVals;
+    u_int16 idx;
+
+    for (idx=0; idx < M76_CALI_WORDS; idx+=2, vals++)  {
+        if ((u_int32)*vals != (CALI_BLOB_DATA(blob, idx) |
+                               ((u_int32)CALI_BLOB_DATA(blob, idx+1) << 16)))
+            return(1);
+    }
+    return(0);
+}
+
 /********************************* ReadCaliProm *****************************
  *
  *  Description: Read calibration values from user EEPROM to calibration 
@@ -2204,6 +4562,8 @@ static int32 ReadCaliProm(LL_HANDLE *llHdl) /* nodoc */
     u_int16 val16;
     int32 *vals = (int32*)&llHdl->caliVals;
 
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_RDPROM);
+
     DBGWRT_2((DBH, "LL - ReadCaliProm\n"));
     
     MWRITE_D16(llHdl->ma, CTRL_REG, UEPROM_SEL);    /* select user EEPROM */
@@ -2225,6 +4585,7 @@ static int32 ReadCaliProm(LL_HANDLE *llHdl) /* nodoc */
            llHdl->ma, (u_int8)idx);
 
     DBGWRT_3((DBH, "  uee Checksum: %x,  calculated checksum: %x\n",help, checkSum));
+    EVT(llHdl, M76_EV_EE_READ, help, checkSum);
 
     /* compare checksum */
     if (checkSum != help)
@@ -2232,6 +4593,7 @@ static int32 ReadCaliProm(LL_HANDLE *llHdl) /* nodoc */
 
     MWRITE_D16(llHdl->ma, CTRL_REG, IDPROM_SEL);    /* deselect user EEPROM */
 
+    M76_TRC_LEAVE(llHdl->ma);
     return (error);
 }
 
@@ -2252,6 +4614,8 @@ static int32 WriteCaliProm(LL_HANDLE *llHdl)    /* nodoc */
     u_int16 idx, checkSum = 0;
     u_int16 val16;
 
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_WRPROM);
+
     DBGWRT_2((DBH, "LL - WriteCaliProm\n"));
 
     MWRITE_D16(llHdl->ma, CTRL_REG, UEPROM_SEL);    /* select user EEPROM */
@@ -2285,6 +4649,7 @@ static int32 WriteCaliProm(LL_HANDLE *llHdl)    /* nodoc */
     
     MWRITE_D16(llHdl->ma, CTRL_REG, IDPROM_SEL);    /* deselect user EEPROM */
 
+    M76_TRC_LEAVE(llHdl->ma);
     return (error);
 }
 
@@ -2301,6 +4666,8 @@ static int32 UeeWrite(LL_HANDLE *llHdl, u_int8 index, u_int16 value)/* nodoc */
 {
     int32 error=0,cycle=10;
 
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_UEEWRITE);
+
     /* 
      * try several times to write, as with high system load you might 
      * not detect final busy signal from eeprom 
@@ -2318,9 +4685,14 @@ static int32 UeeWrite(LL_HANDLE *llHdl, u_int8 index, u_int16 value)/* nodoc */
                       index,value,error,cycle));
 
     if (error)  {
+        EVT(llHdl, M76_EV_EE_ERR, index, error);
         error = ERR_LL_WRITE;
     }
+    else  {
+        EVT(llHdl, M76_EV_EE_WRITE, index, value);
+    }
 
+    M76_TRC_LEAVE(llHdl->ma);
     return (error);
 }
 
@@ -2340,41 +4712,1836 @@ static int32 ReadDataReg(LL_HANDLE *llHdl, int32 *value, int32 reg) /* nodoc */
 {
     int32 error;
     u_int32 i=0;
-    u_int16 com, acc;
 
-    /* next operation is a read from the Data Register */
-    com = (u_int16)(reg | COM_READ | llHdl->comChan);
-    MWRITE_D16(llHdl->ma, COM_REG, com);
+    NbCancel(llHdl);
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_DATAREG);
 
     if (llHdl->irqEnable)  {        /* read using interrupt */
-        acc = (TR24R | IRQ);
-        MWRITE_D16(llHdl->ma, ACCESS_REG, acc);
-
-        DBGWRT_2((DBH, "LL - ReadDataReg (int): %x %x\n",com,acc));
+        /* next operation is a read from the Data Register */
+        StartDataReg(llHdl, reg, TR24R | IRQ);
 
         error = OSS_SemWait( llHdl->osHdl, llHdl->readSem, 2000);
-        if (error)
+        if (error)  {
+            llHdl->acq.semTout++;
+            EVT(llHdl, M76_EV_SEM_TOUT, error, reg);
+            M76_TRC_LEAVE(llHdl->ma);
             return (error);
+        }
+        HistAdd(llHdl->acq.irqWake, M76_EVT_TIME(llHdl) - llHdl->irqTime);
     
-        *value = (MREAD_D16(llHdl->ma, DATA_REG) << 16);
-        *value |= MREAD_D16(llHdl->ma, DATA_REG+2);
+        *value = GetDataReg(llHdl);
     }
     else  {                         /* read polling */
-        acc = (TR24R);
-        MWRITE_D16(llHdl->ma, ACCESS_REG, acc);
-
-        DBGWRT_2((DBH, "LL - ReadDataReg (pol): %x %x\n",com,acc));
+        /* next operation is a read from the Data Register */
+        StartDataReg(llHdl, reg, TR24R);
 
         while  ((MREAD_D16(llHdl->ma, STAT_REG) & TRDYR) == 0 )  {
             OSS_Delay(llHdl->osHdl,10);
             i++;
             if (i >= POLL_TOUT)  {
+                llHdl->acq.pollTout++;
+                EVT(llHdl, M76_EV_POLL_TOUT, i, reg);
+                M76_TRC_LEAVE(llHdl->ma);
                 return(ERR_LL_DEV_NOTRDY);
             }
         }
-        *value = (MREAD_D16(llHdl->ma, DATA_REG) << 16);
-        *value |= MREAD_D16(llHdl->ma, DATA_REG+2);
+        *value = GetDataReg(llHdl);
     }   
+    M76_TRC_LEAVE(llHdl->ma);
     return(ERR_SUCCESS);
 }
 
+/********************************* StartDataReg *****************************
+ *
+ *  Description: Select ADC register to be read via Data Register and
+ *               start the transfer.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               reg        ADC register to be read via data register
+ *               acc        Access Register bits (TR24R, IRQ)
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void StartDataReg(LL_HANDLE *llHdl, int32 reg, u_int16 acc) /* nodoc */
+{
+    u_int16 com;
+
+    /* next operation is a read from the Data Register */
+    com = (u_int16)(reg | COM_READ | llHdl->comChan);
+    MWRITE_D16(llHdl->ma, COM_REG, com);
+
+    MWRITE_D16(llHdl->ma, ACCESS_REG, acc);
+    llHdl->convStart = M76_EVT_TIME(llHdl);
+    llHdl->xferReg = reg;
+    EVT(llHdl, M76_EV_START, com, acc);
+}
+
+/********************************* GetDataReg *******************************
+ *
+ *  Description: Get value from Data Register after transfer is ready.
+ *               A 16-bit conversion result (M76_FAST) is left-aligned in
+ *               the high word, the low word is not read.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: return     read value
+ *  Globals....: -
+ ****************************************************************************/
+static int32 GetDataReg(LL_HANDLE *llHdl)   /* nodoc */
+{
+    int32 value;
+
+    value = (MREAD_D16(llHdl->ma, DATA_REG) << 16);
+    if (!llHdl->fast || (llHdl->xferReg != COM_DATA))
+        value |= MREAD_D16(llHdl->ma, DATA_REG+2);
+    llHdl->acq.reads++;
+    HistAdd(llHdl->acq.convLat, M76_EVT_TIME(llHdl) - llHdl->convStart);
+    EVT(llHdl, M76_EV_SAMPLE, value, llHdl->comChan);
+
+    return(value);
+}
+
+/********************************* JobStart *********************************
+ *
+ *  Description: Start asynchronous job (M76_ASYNC).
+ *               The job is performed step by step by JobAlarm().
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               type       M76_JOBTYPE_CALI or M76_JOBTYPE_STORE
+ *               kind       calibration kind (M76_JOBTYPE_CALI)
+ *  Output.....: return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 JobStart(LL_HANDLE *llHdl, u_int32 type, int32 kind)  /* nodoc */
+{
+    int32 error;
+
+    DBGWRT_2((DBH, "LL - JobStart: type=%d kind=%d\n",type,kind));
+
+    if (llHdl->jobState == M76_JOB_BUSY)
+        return(ERR_LL_DEV_BUSY);
+    if ((type == M76_JOBTYPE_CALI) && CheckCaliKind(llHdl->range, kind))
+        return(ERR_LL_ILL_PARAM);
+
+    NbCancel(llHdl);
+    llHdl->jobType   = type;
+    llHdl->jobKind   = kind;
+    llHdl->jobStep   = 0;
+    llHdl->jobCnt    = 0;
+    llHdl->jobIdx    = 0;
+    llHdl->jobValue  = 0;
+    llHdl->jobError  = 0;
+    llHdl->jobCancel = FALSE;
+    llHdl->jobRestore = FALSE;
+    llHdl->jobState  = M76_JOB_BUSY;
+    EVT(llHdl, M76_EV_JOB_START, type, kind);
+
+    error = OSS_AlarmSet(llHdl->osHdl, llHdl->jobAlarm, JOB_TICK, FALSE,
+                         &llHdl->jobTick);
+    if (error)  {
+        llHdl->jobError = error;
+        llHdl->jobState = M76_JOB_ERROR;
+    }
+    return(error);
+}
+
+/********************************* JobAlarm *********************************
+ *
+ *  Description: Alarm routine of asynchronous job, performs the next step
+ *               and re-arms the alarm while the job is running.
+ *---------------------------------------------------------------------------
+ *  Input......: arg        low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void JobAlarm(void *arg) /* nodoc */
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+
+    if (llHdl->jobState != M76_JOB_BUSY)
+        return;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_ALARM);
+
+    if (llHdl->jobType == M76_JOBTYPE_CALI)
+        JobCaliStep(llHdl);
+    else
+        JobStoreStep(llHdl);
+
+    if (llHdl->jobState == M76_JOB_BUSY)  {
+        if (OSS_AlarmSet(llHdl->osHdl, llHdl->jobAlarm, JOB_TICK, FALSE,
+                         &llHdl->jobTick))
+            JobEnd(llHdl, ERR_LL_DEV_NOTRDY);
+    }
+    M76_TRC_LEAVE(llHdl->ma);
+}
+
+/********************************* JobCaliStep ******************************
+ *
+ *  Description: Perform next step of asynchronous calibration.
+ *               Same sequence as CalibAdc(), but TRDYR is polled once per
+ *               alarm and delays are counted in alarm periods.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void JobCaliStep(LL_HANDLE *llHdl)   /* nodoc */
+{
+    int32 kind = llHdl->jobKind;
+    int32 im   = (kind == 3) || (kind == 4);        /* Im calibration */
+    int32 zero = (kind == 0) || (kind == 2) || (kind == 4);
+
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_JOBCALI);
+
+    if (llHdl->jobCancel && (llHdl->jobStep < JS_CALI_RESTORE))  {
+        MWRITE_D16(llHdl->ma, ACCESS_REG, 0);
+        llHdl->jobStep = JS_CALI_RESTORE;
+    }
+
+    switch (llHdl->jobStep)  {
+    case JS_CALI_CHAN:
+        if (im)  {
+            /* special Im parameters */
+            llHdl->jobGain = llHdl->modGain;    /* store gain for Ux */
+            llHdl->modGain = MOD_GAIN_1;
+            llHdl->comChan = COM_R_I;
+            WriteFilterReg(llHdl);
+            WriteModeReg(llHdl);  
+            if (kind == 3)
+                WriteCaliReg(llHdl);    /* write Im zero-scale calibration val */
+            llHdl->jobCnt = 0;
+            llHdl->jobStep = JS_CALI_SETTLE;
+        }
+        else  {
+            llHdl->jobStep = JS_CALI_START;
+        }
+        break;
+
+    case JS_CALI_SETTLE:    /* channel changed */
+        llHdl->jobCnt += llHdl->jobTick;
+        if (llHdl->jobCnt >= llHdl->settleTime)
+            llHdl->jobStep = JS_CALI_START;
+        break;
+
+    case JS_CALI_START:
+        /* initiate calibration, wait at least one modulator cycle */
+        llHdl->modMode = zero ? MOD_ZERO : MOD_FULL;
+        WriteModeReg(llHdl);
+        llHdl->modMode = MOD_NORMAL;
+        llHdl->jobStep = JS_CALI_DATA;
+        break;
+
+    case JS_CALI_DATA:
+        StartDataReg(llHdl, COM_DATA, TR24R);
+        llHdl->jobCnt = 0;
+        llHdl->jobStep = JS_CALI_DATA_WAIT;
+        break;
+
+    case JS_CALI_DATA_WAIT:
+    case JS_CALI_REG_WAIT:
+        if ((MREAD_D16(llHdl->ma, STAT_REG) & TRDYR) == 0)  {
+            llHdl->jobCnt += llHdl->jobTick;
+            if (llHdl->jobCnt >= POLL_TOUT*10)  {
+                llHdl->jobError = ERR_LL_DEV_NOTRDY;
+                MWRITE_D16(llHdl->ma, ACCESS_REG, 0);
+                llHdl->jobStep = JS_CALI_RESTORE;
+            }
+            break;
+        }
+        if (llHdl->jobStep == JS_CALI_DATA_WAIT)  {
+            GetDataReg(llHdl);
+            StartDataReg(llHdl, zero ? COM_CALI_ZERO : COM_CALI_FULL, TR24R);
+            llHdl->jobCnt = 0;
+            llHdl->jobStep = JS_CALI_REG_WAIT;
+        }
+        else  {
+            llHdl->jobValue = GetDataReg(llHdl);
+            llHdl->jobStep = JS_CALI_RESTORE;
+        }
+        break;
+
+    case JS_CALI_RESTORE:
+        if (im)  {
+            /* set ADC to default R parameters (Ux) */
+            llHdl->comChan = COM_R_U;
+            llHdl->modGain = llHdl->jobGain;
+            WriteFilterReg(llHdl);
+            WriteModeReg(llHdl);  
+            WriteCaliReg(llHdl);
+            llHdl->jobCnt = 0;
+            llHdl->jobStep = JS_CALI_SETTLE2;
+        }
+        else  {
+            JobEnd(llHdl, llHdl->jobError);
+        }
+        break;
+
+    case JS_CALI_SETTLE2:
+        llHdl->jobCnt += llHdl->jobTick;
+        if (llHdl->jobCnt >= llHdl->settleTime)
+            JobEnd(llHdl, llHdl->jobError);
+        break;
+    }
+    M76_TRC_LEAVE(llHdl->ma);
+}
+
+/********************************* JobStoreStep *****************************
+ *
+ *  Description: Perform next step of asynchronous calibration store.
+ *               Same result as WriteCaliProm(), but the erase/write cycles
+ *               of the user EEPROM are polled once per alarm. Unchanged
+ *               words are skipped, the previous words are kept to write
+ *               them back if the store is canceled.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void JobStoreStep(LL_HANDLE *llHdl)  /* nodoc */
+{
+    int32 *vals = (int32*)&llHdl->caliVals;
+    u_int32 busy, next = FALSE;
+    u_int16 val16;
+
+    M76_TRC_ENTER(llHdl->ma, M76_TRC_SC_JOBSTORE);
+
+    /* word to write: calibration values, checksum at the end 
+       or previous word after cancel */
+    if (llHdl->jobRestore)
+        val16 = llHdl->jobOld[llHdl->jobIdx];
+    else if (llHdl->jobIdx < M76_CALI_WORDS)
+        val16 = (u_int16)((vals[llHdl->jobIdx/2] >> 
+                           ((llHdl->jobIdx & 1) ? 16 : 0)) & 0xffff);
+    else
+        val16 = llHdl->jobCheckSum;
+
+    if (llHdl->jobCancel && !llHdl->jobRestore)  {
+        /* words 0..jobIdx-1 written, word jobIdx erased/written if busy */
+        busy = (llHdl->jobStep == JS_STORE_ERASE_WAIT) ||
+               (llHdl->jobStep == JS_STORE_WRITE_WAIT);
+        if (busy)
+            __M76_UeeFinish(llHdl->osHdl, llHdl->ma);
+
+        if ((llHdl->jobStep == JS_STORE_START) || 
+            (llHdl->jobIdx + busy == 0))
+            JobEnd(llHdl, 0);
+        else  {
+            /* write back previous words */
+            llHdl->jobLast    = llHdl->jobIdx + busy - 1;
+            llHdl->jobIdx     = 0;
+            llHdl->jobRestore = TRUE;
+            llHdl->jobStep    = JS_STORE_SAVE;
+        }
+        M76_TRC_LEAVE(llHdl->ma);
+        return;
+    }
+
+    switch (llHdl->jobStep)  {
+    case JS_STORE_START:
+        MWRITE_D16(llHdl->ma, CTRL_REG, UEPROM_SEL);    /* select user EEPROM */
+        llHdl->jobCheckSum = CaliChecksum(vals);
+        llHdl->jobStep = JS_STORE_SAVE;
+        break;
+
+    case JS_STORE_SAVE:
+        {
+            u_int16 cur = (u_int16)__M76_UeeRead(llHdl->osHdl, llHdl->ma,
+                                                 (u_int8)llHdl->jobIdx);
+            if (!llHdl->jobRestore)
+                llHdl->jobOld[llHdl->jobIdx] = cur;
+            if (cur == val16)  {
+                next = TRUE;            /* unchanged */
+                break;
+            }
+            llHdl->jobRetry = JOB_UEE_RETRY;
+            llHdl->jobStep = JS_STORE_ERASE;
+        }
+        break;
+
+    case JS_STORE_ERASE:
+        __M76_UeeEraseStart(llHdl->osHdl, llHdl->ma, (u_int8)llHdl->jobIdx);
+        llHdl->jobCnt = 0;
+        llHdl->jobStep = JS_STORE_ERASE_WAIT;
+        break;
+
+    case JS_STORE_ERASE_WAIT:
+    case JS_STORE_WRITE_WAIT:
+        if (__M76_UeeReady(llHdl->osHdl, llHdl->ma) == 0)  {
+            llHdl->jobCnt += llHdl->jobTick;
+            if (llHdl->jobCnt >= JOB_UEE_TOUT)  {
+                /* try again, as with high system load */
+                __M76_UeeFinish(llHdl->osHdl, llHdl->ma);
+                EVT(llHdl, M76_EV_EE_ERR, llHdl->jobIdx, ERR_LL_DEV_NOTRDY);
+                if (--llHdl->jobRetry == 0)
+                    JobEnd(llHdl, ERR_LL_WRITE);
+                else
+                    llHdl->jobStep = JS_STORE_ERASE;
+            }
+            break;
+        }
+        __M76_UeeFinish(llHdl->osHdl, llHdl->ma);
+
+        if (llHdl->jobStep == JS_STORE_ERASE_WAIT)  {
+            __M76_UeeWriteStart(llHdl->osHdl, llHdl->ma, 
+                                (u_int8)llHdl->jobIdx, val16);
+            llHdl->jobCnt = 0;
+            llHdl->jobStep = JS_STORE_WRITE_WAIT;
+            break;
+        }
+
+        /* verify data */
+        if (val16 != __M76_UeeRead(llHdl->osHdl, llHdl->ma, 
+                                   (u_int8)llHdl->jobIdx))  {
+            DBGWRT_ERR((DBH, " *** JobStoreStep: verify error idx=%x\n",
+                        llHdl->jobIdx));
+            EVT(llHdl, M76_EV_EE_ERR, llHdl->jobIdx, ERR_LL_WRITE);
+            JobEnd(llHdl, ERR_LL_WRITE);
+            break;
+        }
+        EVT(llHdl, M76_EV_EE_WRITE, llHdl->jobIdx, val16);
+        next = TRUE;
+        break;
+    }
+
+    if (next)  {
+        if (++llHdl->jobIdx <= 
+            (llHdl->jobRestore ? llHdl->jobLast : M76_CALI_WORDS))
+            llHdl->jobStep = JS_STORE_SAVE;
+        else if (llHdl->jobRestore)
+            JobEnd(llHdl, 0);           /* previous words restored */
+        else  {
+            /* checksum written */
+            llHdl->checkSum = TRUE;
+            llHdl->permitMeas = TRUE;
+            llHdl->caliSrc = M76_CALI_SRC_EEPROM;
+            llHdl->caliDirty = 0;
+            JobEnd(llHdl, 0);
+        }
+    }
+    M76_TRC_LEAVE(llHdl->ma);
+}
+
+/********************************* JobEnd ***********************************
+ *
+ *  Description: Finish asynchronous job and set final job state.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               error      error code of job
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void JobEnd(LL_HANDLE *llHdl, int32 error)   /* nodoc */
+{
+    DBGWRT_2((DBH, "LL - JobEnd: type=%d error=0x%x cancel=%d\n",
+              llHdl->jobType,error,llHdl->jobCancel));
+
+    if (llHdl->jobType == M76_JOBTYPE_STORE)
+        MWRITE_D16(llHdl->ma, CTRL_REG, IDPROM_SEL);    /* deselect user EEPROM */
+
+    llHdl->jobError = error;
+
+    if (llHdl->jobCancel)
+        llHdl->jobState = M76_JOB_CANCELED;
+    else if (error)
+        llHdl->jobState = M76_JOB_ERROR;
+    else
+        llHdl->jobState = M76_JOB_DONE;
+
+    EVT(llHdl, M76_EV_JOB_END, llHdl->jobState, error);
+}
+
+/********************************* EvtPut ***********************************
+ *
+ *  Description: Put event into event ring (see M76_BLK_EVT).
+ *               Only a few stores, callable from interrupt. An event
+ *               put by an interrupt while EvtPut runs may share its entry
+ *               (diagnostic aid, no locking).
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               id         M76_EV_xxx
+ *               arg0       first argument
+ *               arg1       second argument
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void EvtPut(LL_HANDLE *llHdl, u_int32 id, u_int32 arg0, u_int32 arg1)  /* nodoc */
+{
+    EVT_ENTRY *e = &llHdl->evt[llHdl->evtCnt++ % EVT_NUM];
+
+    e->time   = M76_EVT_TIME(llHdl);
+    e->id     = id;
+    e->arg[0] = arg0;
+    e->arg[1] = arg1;
+}
+
+/********************************* Settle ***********************************
+ *
+ *  Description: Wait settle time after range/ADC channel was changed and
+ *               update acquisition statistics.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void Settle(LL_HANDLE *llHdl)    /* nodoc */
+{
+    u_int32 t = M76_EVT_TIME(llHdl);
+
+    OSS_Delay(llHdl->osHdl, llHdl->settleTime);
+
+    llHdl->acq.settles++;
+    llHdl->acq.settleMs += llHdl->settleTime;
+    HistAdd(llHdl->acq.settle, M76_EVT_TIME(llHdl) - t);
+
+    llHdl->adaptCnt = 0;            /* restart noise estimate */
+    llHdl->adaptReq = 0;
+    llHdl->zcalValid = FALSE;       /* new self-calibration base */
+}
+
+/********************************* HistAdd **********************************
+ *
+ *  Description: Count time in log2 histogram (see M76_ACQ_STAT).
+ *---------------------------------------------------------------------------
+ *  Input......: hist       histogram (ACQ_BINS bins)
+ *               t          time [ticks]
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void HistAdd(u_int32 *hist, u_int32 t)   /* nodoc */
+{
+    u_int32 bin = 0;
+
+    while (t && (bin < ACQ_BINS-1))  {
+        t >>= 1;
+        bin++;
+    }
+    hist[bin]++;
+}
+
+/********************************* ReadConv *********************************
+ *
+ *  Description: Read one conversion of current channel, add it to the
+ *               streaming statistics and check the alarm limits.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: valueP     raw 24-bit code, right-aligned
+ *               return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 ReadConv(LL_HANDLE *llHdl, int32 *valueP)  /* nodoc */
+{
+    int32 error;
+
+    error = ReadDataReg(llHdl, valueP, COM_DATA);
+
+    *valueP >>= 8;
+    *valueP &= 0x00ffffff;
+
+    if (llHdl->statOn && !error)
+        StatAdd(llHdl, *valueP);
+    if (llHdl->almOn && !error)
+        AlmCheck(llHdl, *valueP);
+    if (llHdl->adaptTarget && !error)
+        AdaptAdd(llHdl, *valueP);
+    return(error);
+}
+
+/********************************* ReadSample *******************************
+ *
+ *  Description: Read one sample of current channel: the mean of 2^k
+ *               conversions (M76_OVS) with M76_OVS_FRAC fraction bits.
+ *               The sum is accumulated in 64 bit, only shifts are used.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: valueP     sample, right-aligned
+ *               return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 ReadSample(LL_HANDLE *llHdl, int32 *valueP)  /* nodoc */
+{
+    u_int32 k = llHdl->ovsK[llHdl->range], frac = llHdl->ovsFrac, i;
+    u_int64 acc = 0;
+    int32 error;
+
+    if ((k | frac) == 0)                /* single conversion */
+        return(ReadConv(llHdl, valueP));
+
+    for (i=0; i < (1UL << k); i++)  {
+        if ((error = ReadConv(llHdl, valueP)))
+            return(error);
+        acc += (u_int32)*valueP;
+    }
+
+    /* mean * 2^frac = acc >> (k-frac) */
+    if (k > frac)  {
+        if (llHdl->ovsRnd)
+            acc += (u_int64)1 << (k - frac - 1);
+        acc >>= k - frac;
+    }
+    else
+        acc <<= frac - k;
+
+    *valueP = (int32)acc;
+    return(0);
+}
+
+/********************************* PostFilter *******************************
+ *
+ *  Description: Read conversion(s) and apply post-filter (M76_PFILT).
+ *               An empty window (pfCnt=0) is filled first.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: valueP     filtered sample
+ *               return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 PostFilter(LL_HANDLE *llHdl, int32 *valueP)  /* nodoc */
+{
+    u_int32 n = llHdl->pfN, i, j;
+    int32 x, error, sort[PF_MAX];
+
+    if (llHdl->pfCnt == 0)  {
+        llHdl->pfIdx = 0;
+        llHdl->pfSum = 0;
+        llHdl->pfRem = 0;
+    }
+
+    do {
+        if ((error = ReadSample(llHdl, &x)))
+            return(error);
+
+        if (llHdl->pfType == M76_PFILT_IIR)  {
+            if (llHdl->pfCnt == 0)
+                llHdl->pfAcc = (u_int64)x << n;
+            else
+                llHdl->pfAcc += (u_int64)x - (llHdl->pfAcc >> n);
+            llHdl->pfCnt = n;
+            break;
+        }
+
+        /*
+         * BOX/MEDIAN: replace oldest sample of window
+         * samples have up to 31 bit, the sum is kept as quotients and
+         * remainders of x/N to fit in 32 bit without 64-bit division
+         */
+        if (llHdl->pfCnt == n)  {
+            llHdl->pfSum -= (u_int32)llHdl->pfWin[llHdl->pfIdx] / n;
+            llHdl->pfRem -= (u_int32)llHdl->pfWin[llHdl->pfIdx] % n;
+        }
+        else
+            llHdl->pfCnt++;
+        llHdl->pfWin[llHdl->pfIdx] = x;
+        llHdl->pfSum += (u_int32)x / n;
+        llHdl->pfRem += (u_int32)x % n;
+        if (++llHdl->pfIdx == n)
+            llHdl->pfIdx = 0;
+    } while (llHdl->pfCnt < n);
+
+    switch (llHdl->pfType)  {
+    case M76_PFILT_BOX:
+        *valueP = (int32)(llHdl->pfSum + (llHdl->pfRem + n/2) / n);
+        break;
+    case M76_PFILT_MEDIAN:
+        /* insertion sort of window copy */
+        for (i=0; i<n; i++)  {
+            x = llHdl->pfWin[i];
+            for (j=i; (j > 0) && (sort[j-1] > x); j--)
+                sort[j] = sort[j-1];
+            sort[j] = x;
+        }
+        if (n & 1)
+            *valueP = sort[n/2];
+        else
+            *valueP = sort[n/2-1] + (sort[n/2] - sort[n/2-1] + 1) / 2;
+        break;
+    default:    /* M76_PFILT_IIR */
+        *valueP = (int32)((llHdl->pfAcc + ((u_int64)1 << (n-1))) >> n);
+    }
+    return(0);
+}
+
+/********************************* StatAdd **********************************
+ *
+ *  Description: Add conversion to streaming statistics (Welford).
+ *
+ *               mean += (x-mean)/n, m2 += (x-mean_old)*(x-mean_new)
+ *               in fixed point with M76_STAT_Q fraction bits. With 24-bit
+ *               codes both deviations are below 2^32, their product fits
+ *               in 64 bit. The rounding error of mean does not add up
+ *               but stays below one fraction LSB. m2 is below
+ *               count * 2^46 * 2^M76_STAT_Q, so a window of up to
+ *               M76_STAT_WIN_MAX conversions can't overflow, without
+ *               window m2 saturates.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               x          raw 24-bit code
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void StatAdd(LL_HANDLE *llHdl, int32 x)  /* nodoc */
+{
+    STAT_SET *s = &llHdl->statCur;
+    int64 xq = (int64)x << M76_STAT_Q;
+    u_int64 d1, d2;
+
+    if (s->count == 0)  {
+        s->count = 1;
+        s->min   = s->max = x;
+        s->mean  = xq;
+        s->m2    = 0;
+    }
+    else  {
+        s->count++;
+        if (x < s->min)
+            s->min = x;
+        if (x > s->max)
+            s->max = x;
+
+        /* both deviations have the same sign, use magnitudes */
+        if (xq >= s->mean)  {
+            d1 = (u_int64)(xq - s->mean);
+            s->mean += (int64)Div64(d1, s->count);
+            d2 = (u_int64)(xq - s->mean);
+        }
+        else  {
+            d1 = (u_int64)(s->mean - xq);
+            s->mean -= (int64)Div64(d1, s->count);
+            d2 = (u_int64)(s->mean - xq);
+        }
+        d1 = (d1 * d2) >> M76_STAT_Q;
+        s->m2 = (s->m2 > ~(u_int64)0 - d1) ? ~(u_int64)0 : s->m2 + d1;
+    }
+
+    if (llHdl->statWin && (s->count >= llHdl->statWin))  {
+        llHdl->statLast = *s;
+        llHdl->statWins++;
+        s->count = 0;
+    }
+}
+
+/********************************* Div64 ************************************
+ *
+ *  Description: Unsigned 64/32-bit division by shift and subtract.
+ *               The kernel of 32-bit targets has no 64-bit division.
+ *---------------------------------------------------------------------------
+ *  Input......: a          dividend
+ *               b          divisor (>0)
+ *  Output.....: return     a / b
+ *  Globals....: -
+ ****************************************************************************/
+static u_int64 Div64(u_int64 a, u_int32 b)  /* nodoc */
+{
+    u_int64 q = 0, r = 0;
+    int32 i;
+
+    for (i=63; i>=0; i--)  {
+        r = (r << 1) | ((a >> i) & 1);
+        if (r >= b)  {
+            r -= b;
+            q |= (u_int64)1 << i;
+        }
+    }
+    return(q);
+}
+
+/********************************* StatCopy *********************************
+ *
+ *  Description: Copy statistics set to user structure.
+ *---------------------------------------------------------------------------
+ *  Input......: src        statistics set
+ *  Output.....: dst        user structure
+ *  Globals....: -
+ ****************************************************************************/
+static void StatCopy(M76_STAT_SET *dst, STAT_SET *src)  /* nodoc */
+{
+    dst->count    = src->count;
+    dst->min      = src->count ? src->min : 0;
+    dst->max      = src->count ? src->max : 0;
+    dst->reserved = 0;
+    dst->mean     = src->count ? src->mean : 0;
+    dst->m2       = src->count ? src->m2 : 0;
+}
+
+
+/********************************* EnvRead **********************************
+ *
+ *  Description: Read envelope records (M76_ENV_N conversions each).
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl        low-level handle 
+ *               size         buffer size
+ *  Output.....: env          records
+ *               nbrRdBytesP  number of read bytes
+ *               return       success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 EnvRead(                           /* nodoc */
+    LL_HANDLE *llHdl,
+    M76_ENV *env,
+    int32 size,
+    int32 *nbrRdBytesP)
+{
+    u_int32 num = (u_int32)size / sizeof(M76_ENV), n = llHdl->envN, i, r;
+    u_int64 sum;
+    int32 x, error;
+
+    if (num == 0)
+        return(ERR_LL_USERBUF);
+    if (llHdl->permitMeas == FALSE)     /* wrong checksum */
+        return(ERR_LL_DEV_NOTRDY);
+    if (llHdl->calibOk == FALSE)        /* not calibrated */
+        return(ERR_LL_DEV_NOTRDY);
+
+    for (r=0; r<num; r++, env++)  {
+        for (sum=0, i=0; i<n; i++)  {
+            if ((error = ReadConv(llHdl, &x)))
+                return(error);
+            if ((i == 0) || (x < env->min))
+                env->min = x;
+            if ((i == 0) || (x > env->max))
+                env->max = x;
+            sum += (u_int32)x;
+        }
+        env->mean  = (int32)Div64(sum + n/2, n);
+        env->count = n;
+    }
+
+    if (llHdl->adaptReq)                /* filter step between records */
+        AdaptApply(llHdl);
+
+    *nbrRdBytesP = num * sizeof(M76_ENV);
+    return(ERR_SUCCESS);
+}
+
+/********************************* DeadBand *********************************
+ *
+ *  Description: Check value against dead-band and heartbeat, take it as
+ *               new reference if it is reported.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               value      sample
+ *  Output.....: return     TRUE: report value, FALSE: drop it
+ *  Globals....: -
+ ****************************************************************************/
+static int32 DeadBand(LL_HANDLE *llHdl, int32 value)   /* nodoc */
+{
+    u_int32 now = M76_EVT_TIME(llHdl), band;
+    int32 diff = value - llHdl->dbLast, sv = value;
+
+    if (llHdl->dbValid &&
+        ((diff < 0 ? (u_int32)-diff : (u_int32)diff) <= llHdl->dbBand) &&
+        (now - llHdl->dbTime < llHdl->dbHeartTicks))
+        return(FALSE);
+
+    /* new reference, relative band computed once per report */
+    /* on the signed value (zero at mid-scale in bipolar ranges) */
+    if (llHdl->filPolarity == FHI_POLAR_BI)
+        sv -= (int32)(0x800000UL << llHdl->ovsFrac);
+    band = llHdl->dbRel ? 
+        (u_int32)Div64((u_int64)(sv < 0 ? (u_int32)-sv : (u_int32)sv) * 
+                       llHdl->dbRel, 1000000) : 0;
+    llHdl->dbBand  = band > llHdl->dbAbs ? band : llHdl->dbAbs;
+    llHdl->dbLast  = value;
+    llHdl->dbTime  = now;
+    llHdl->dbValid = TRUE;
+    return(TRUE);
+}
+
+/********************************* MsToTicks ********************************
+ *
+ *  Description: Convert time [ms] to ticks of M76_EVT_TIME.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               ms         time [ms]
+ *  Output.....: return     ticks (at least 1 for ms > 0)
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 MsToTicks(LL_HANDLE *llHdl, u_int32 ms)    /* nodoc */
+{
+    u_int32 rate = M76_EVT_RATE(llHdl), t;
+
+    t = (ms / 1000) * rate + (ms % 1000) * rate / 1000;
+    return((ms && !t) ? 1 : t);
+}
+
+/********************************* TrgRead **********************************
+ *
+ *  Description: Wait for trigger and read trigger record.
+ *
+ *               The pre-trigger history is kept as ring in the data area
+ *               of the record and rotated into order after the trigger.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl        low-level handle 
+ *               size         buffer size
+ *  Output.....: rec          trigger record
+ *               nbrRdBytesP  number of read bytes
+ *               return       success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 TrgRead(                           /* nodoc */
+    LL_HANDLE *llHdl,
+    M76_TRG_REC *rec,
+    int32 size,
+    int32 *nbrRdBytesP)
+{
+    u_int32 pre = llHdl->trgPre, num = 0, idx = 0, waited = 0, i, start;
+    int32 *data = rec->data, x, prev = 0, hit, error;
+
+    if ((u_int32)size < M76_TRG_REC_SIZE(pre + llHdl->trgPost))
+        return(ERR_LL_USERBUF);
+    if (llHdl->permitMeas == FALSE)     /* wrong checksum */
+        return(ERR_LL_DEV_NOTRDY);
+    if (llHdl->calibOk == FALSE)        /* not calibrated */
+        return(ERR_LL_DEV_NOTRDY);
+
+    start = M76_EVT_TIME(llHdl);
+
+    for (;;)  {
+        if ((error = ReadConv(llHdl, &x)))
+            return(error);
+
+        switch (llHdl->trgMode)  {
+        case M76_TRG_RISING:
+            hit = waited && (prev < llHdl->trgLevel) && (x >= llHdl->trgLevel);
+            break;
+        case M76_TRG_FALLING:
+            hit = waited && (prev > llHdl->trgLevel) && (x <= llHdl->trgLevel);
+            break;
+        default:    /* M76_TRG_WINDOW */
+            hit = (x < llHdl->trgLevel) || (x > llHdl->trgLevel2);
+        }
+        if (hit)
+            break;
+
+        if (M76_EVT_TIME(llHdl) - start >= llHdl->trgToutTicks)
+            return(ERR_OSS_TIMEOUT);
+
+        /* keep history */
+        if (pre)  {
+            data[idx] = x;
+            if (++idx == pre)
+                idx = 0;
+            if (num < pre)
+                num++;
+        }
+        prev = x;
+        waited++;
+    }
+    rec->time = M76_EVT_TIME(llHdl);
+    EVT(llHdl, M76_EV_TRIGGER, x, waited);
+
+    /* oldest sample first: rotate ring left by idx */
+    if (num == pre)  {
+        Reverse(data, idx);
+        Reverse(data + idx, pre - idx);
+        Reverse(data, pre);
+    }
+
+    /* trigger sample and post-trigger samples */
+    data[num] = x;
+    for (i=1; i<llHdl->trgPost; i++)  {
+        if ((error = ReadConv(llHdl, &data[num+i])))
+            return(error);
+    }
+
+    rec->pre      = num;
+    rec->post     = llHdl->trgPost;
+    rec->tickRate = M76_EVT_RATE(llHdl);
+    rec->waited   = waited;
+    rec->reserved = 0;
+
+    if (llHdl->adaptReq)                /* filter step after the record */
+        AdaptApply(llHdl);
+
+    *nbrRdBytesP = sizeof(M76_TRG_REC) - sizeof(int32) +
+                   FmtWords(llHdl, data, num + llHdl->trgPost);
+    return(ERR_SUCCESS);
+}
+
+/********************************* Reverse **********************************
+ *
+ *  Description: Reverse order of array in place.
+ *---------------------------------------------------------------------------
+ *  Input......: p          array
+ *               n          number of elements
+ *  Output.....: p          reversed array
+ *  Globals....: -
+ ****************************************************************************/
+static void Reverse(int32 *p, u_int32 n)    /* nodoc */
+{
+    int32 t, *q;
+
+    if (n < 2)
+        return;
+    for (q = p + n - 1; p < q; p++, q--)  {
+        t  = *p;
+        *p = *q;
+        *q = t;
+    }
+}
+
+/********************************* AlmCheck *********************************
+ *
+ *  Description: Check conversion against alarm limits (with hysteresis),
+ *               latch violation and send signal.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               x          raw 24-bit code
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void AlmCheck(LL_HANDLE *llHdl, int32 x)   /* nodoc */
+{
+    u_int32 state = llHdl->almState, hit = 0;
+
+    if (state & M76_ALM_HI_ACT)  {
+        if (x < llHdl->almHigh - (int32)llHdl->almHyst)
+            state &= ~M76_ALM_HI_ACT;
+    }
+    else if (x > llHdl->almHigh)
+        hit |= M76_ALM_HI | M76_ALM_HI_ACT;
+
+    if (state & M76_ALM_LO_ACT)  {
+        if (x > llHdl->almLow + (int32)llHdl->almHyst)
+            state &= ~M76_ALM_LO_ACT;
+    }
+    else if (x < llHdl->almLow)
+        hit |= M76_ALM_LO | M76_ALM_LO_ACT;
+
+    llHdl->almState = state | hit;
+
+    if (hit)  {
+        EVT(llHdl, M76_EV_ALARM, hit & (M76_ALM_HI | M76_ALM_LO), x);
+        if (llHdl->almSig)
+            OSS_SigSend(llHdl->osHdl, llHdl->almSig);
+    }
+}
+
+/********************************* NbRead ***********************************
+ *
+ *  Description: Non-blocking read (M76_NBLOCK): fetch the conversion
+ *               started before if it is ready and return it (next) or
+ *               the latest fetched one (latest).
+ *               Ready is taken from readSem (interrupt) or TRDYR (poll)
+ *               without waiting; in latest mode with interrupt M76_Irq 
+ *               fetches. A conversion not ready within 2000 ms is 
+ *               restarted and reported like a blocking timeout.
+ *               Statistics and alarm check of a newly fetched conversion
+ *               are done here, the latest value is taken with the
+ *               interrupt masked.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: valueP     raw 24-bit code, right-aligned
+ *               return     success (0), M76_ERR_NODATA or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 NbRead(LL_HANDLE *llHdl, int32 *valueP)   /* nodoc */
+{
+    u_int16 acc = llHdl->nbPending;
+    int32 error, ready = FALSE, valid, isNew, x;
+    OSS_IRQ_STATE irqState;
+
+    if (acc == 0)                       /* nothing started */
+        NbStart(llHdl);
+    else if (acc & IRQ)  {
+        if ((llHdl->nbOn == M76_NBLOCK_NEXT) &&
+            (OSS_SemWait(llHdl->osHdl, llHdl->readSem, OSS_SEM_NOWAIT) == 0))  {
+            HistAdd(llHdl->acq.irqWake, M76_EVT_TIME(llHdl) - llHdl->irqTime);
+            ready = TRUE;
+        }
+    }
+    else if (MREAD_D16(llHdl->ma, STAT_REG) & TRDYR)
+        ready = TRUE;
+
+    if (ready)
+        NbFetch(llHdl);
+    else if (acc &&
+             (M76_EVT_TIME(llHdl) - llHdl->convStart >= MsToTicks(llHdl, 2000)))  {
+        if (acc & IRQ)  {
+            error = ERR_OSS_TIMEOUT;
+            llHdl->acq.semTout++;
+            EVT(llHdl, M76_EV_SEM_TOUT, error, COM_DATA);
+        }
+        else  {
+            error = ERR_LL_DEV_NOTRDY;
+            llHdl->acq.pollTout++;
+            EVT(llHdl, M76_EV_POLL_TOUT, 0, COM_DATA);
+        }
+        NbCancel(llHdl);
+        NbStart(llHdl);
+        return(error);
+    }
+
+    irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+    valid = llHdl->ltValid;
+    isNew = llHdl->ltNew;
+    x     = llHdl->ltValue;
+    llHdl->ltNew = FALSE;
+    OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+    if (isNew)  {
+        if (llHdl->statOn)
+            StatAdd(llHdl, x);
+        if (llHdl->almOn)
+            AlmCheck(llHdl, x);
+    }
+
+    if ((llHdl->nbOn == M76_NBLOCK_NEXT) ? !ready : !valid)
+        return(M76_ERR_NODATA);
+
+    *valueP = x;
+    return(ERR_SUCCESS);
+}
+
+/********************************* NbFetch **********************************
+ *
+ *  Description: Get ready conversion of non-blocking read, start the next
+ *               one and store it as latest conversion.
+ *               Called from M76_Irq in latest mode, so statistics and
+ *               alarm check are left to NbRead (ltNew).
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void NbFetch(LL_HANDLE *llHdl)  /* nodoc */
+{
+    int32 x = (GetDataReg(llHdl) >> 8) & 0x00ffffff;
+
+    StartDataReg(llHdl, COM_DATA, llHdl->nbPending);
+
+    llHdl->ltValue = x;
+    llHdl->ltTime  = M76_EVT_TIME(llHdl);
+    llHdl->ltValid = TRUE;
+    llHdl->ltNew   = TRUE;
+    llHdl->ltSeq++;
+}
+
+/********************************* NbStart **********************************
+ *
+ *  Description: Start conversion for non-blocking read.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void NbStart(LL_HANDLE *llHdl)  /* nodoc */
+{
+    u_int16 acc = llHdl->irqEnable ? (TR24R | IRQ) : TR24R;
+    OSS_IRQ_STATE irqState;
+
+    /* M76_Irq must see nbPending of the armed transfer */
+    irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+    StartDataReg(llHdl, COM_DATA, acc);
+    llHdl->nbPending = acc;
+    OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+}
+
+/********************************* NbCancel *********************************
+ *
+ *  Description: Discard conversion started for non-blocking read before
+ *               the module is accessed otherwise.
+ *               The interrupt is masked, so M76_Irq can't restart the
+ *               transfer (latest mode) after it was stopped.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void NbCancel(LL_HANDLE *llHdl)  /* nodoc */
+{
+    OSS_IRQ_STATE irqState;
+    u_int16 acc;
+
+    if (llHdl->nbPending == 0)
+        return;
+
+    irqState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+    acc = llHdl->nbPending;
+    MWRITE_D16(llHdl->ma, ACCESS_REG, 0);   /* stop, ack. interrupt */
+    llHdl->nbPending = 0;
+    llHdl->ltValid = FALSE;
+    llHdl->ltNew   = FALSE;
+    OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, irqState);
+
+    if (acc & IRQ)                      /* drop a pending wakeup */
+        OSS_SemWait(llHdl->osHdl, llHdl->readSem, OSS_SEM_NOWAIT);
+}
+
+/********************************* TicksToMs ********************************
+ *
+ *  Description: Convert timestamp difference to milliseconds.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               t          M76_EVT_TIME difference [ticks]
+ *  Output.....: return     time [ms]
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 TicksToMs(LL_HANDLE *llHdl, u_int32 t)    /* nodoc */
+{
+    u_int32 rate = M76_EVT_RATE(llHdl);
+
+    return((t / rate) * 1000 + (t % rate) * 1000 / rate);
+}
+
+/********************************* PaceStart ********************************
+ *
+ *  Description: Start paced sampling (M76_PACE_PERIOD): allocate the 
+ *               queue, start the first conversion and the cyclic alarm.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               period     alarm period [ms]
+ *  Output.....: return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 PaceStart(LL_HANDLE *llHdl, u_int32 period) /* nodoc */
+{
+    u_int32 size = llHdl->paceSize * sizeof(PACE_REC), gotsize, realMs;
+    int32 error;
+
+    if (RANGE_IS_R(llHdl->range))           /* U/I ranges only */
+        return(ERR_LL_ILL_PARAM);
+    if ((llHdl->permitMeas == FALSE) || (llHdl->calibOk == FALSE))
+        return(ERR_LL_DEV_NOTRDY);
+
+    if (llHdl->paceAlloc < size)  {
+        if (llHdl->paceBuf)
+            OSS_MemFree(llHdl->osHdl, (int8*)llHdl->paceBuf, llHdl->paceAlloc);
+        llHdl->paceAlloc = 0;
+        if ((llHdl->paceBuf = (PACE_REC*)OSS_MemGet(
+                 llHdl->osHdl, size, &gotsize)) == NULL)
+            return(ERR_OSS_MEM_ALLOC);
+        llHdl->paceAlloc = gotsize;
+    }
+    if (llHdl->paceAlarm == NULL)  {
+        error = OSS_AlarmCreate(llHdl->osHdl, PaceAlarm, llHdl,
+                                &llHdl->paceAlarm);
+        if (error)
+            return(error);
+    }
+
+    NbCancel(llHdl);
+    llHdl->pacePut = llHdl->paceGet = 0;
+    llHdl->paceSeq = llHdl->paceLost = llHdl->paceLate = 0;
+    llHdl->paceStart = M76_EVT_TIME(llHdl);
+    OSS_SemWait(llHdl->osHdl, llHdl->readSem, OSS_SEM_NOWAIT);
+
+    StartDataReg(llHdl, COM_DATA, TR24R);
+    llHdl->pacePeriod = period;
+    error = OSS_AlarmSet(llHdl->osHdl, llHdl->paceAlarm, period, TRUE, 
+                         &realMs);
+    if (error)  {
+        llHdl->pacePeriod = 0;
+        MWRITE_D16(llHdl->ma, ACCESS_REG, 0);
+        return(error);
+    }
+    llHdl->pacePeriod = realMs;
+    return(ERR_SUCCESS);
+}
+
+/********************************* PaceStop *********************************
+ *
+ *  Description: Stop paced sampling, the queue is discarded.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PaceStop(LL_HANDLE *llHdl)  /* nodoc */
+{
+    OSS_AlarmClear(llHdl->osHdl, llHdl->paceAlarm);
+    llHdl->pacePeriod = 0;
+    llHdl->pacePut = llHdl->paceGet = 0;
+    MWRITE_D16(llHdl->ma, ACCESS_REG, 0);
+    OSS_SemWait(llHdl->osHdl, llHdl->readSem, OSS_SEM_NOWAIT);
+}
+
+/********************************* PaceAlarm ********************************
+ *
+ *  Description: Alarm routine of paced sampling: queue the conversion 
+ *               started in the last period and start the next one.
+ *               An unfinished conversion is left running.
+ *               The queue indices run modulo 2*size to tell full from
+ *               empty without a shared counter. Statistics and alarm
+ *               check are left to PaceRead, so the alarm shares no state
+ *               with the statistics/alarm setstats and getstats.
+ *---------------------------------------------------------------------------
+ *  Input......: arg        low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PaceAlarm(void *arg) /* nodoc */
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+    PACE_REC *rec;
+    u_int32 seq, fill, wrap = 2 * llHdl->paceSize;
+    int32 x;
+
+    if (llHdl->pacePeriod == 0)
+        return;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_ALARM);
+
+    seq = llHdl->paceSeq++;
+    if ((MREAD_D16(llHdl->ma, STAT_REG) & TRDYR) == 0)  {
+        llHdl->paceLate++;
+        M76_TRC_LEAVE(llHdl->ma);
+        return;
+    }
+    x = (GetDataReg(llHdl) >> 8) & 0x00ffffff;
+    StartDataReg(llHdl, COM_DATA, TR24R);   /* next conversion */
+
+    fill = (llHdl->pacePut + wrap - llHdl->paceGet) % wrap;
+    if (fill < llHdl->paceSize)  {
+        rec = &llHdl->paceBuf[llHdl->pacePut % llHdl->paceSize];
+        rec->value = x;
+        rec->seq   = seq;
+        rec->time  = TicksToMs(llHdl, M76_EVT_TIME(llHdl) - llHdl->paceStart);
+        llHdl->pacePut = (llHdl->pacePut + 1) % wrap;
+
+        OSS_SemSignal(llHdl->osHdl, llHdl->readSem);
+        if ((fill + 1 == llHdl->paceWmark) && llHdl->rdySig)
+            OSS_SigSend(llHdl->osHdl, llHdl->rdySig);
+    }
+    else
+        llHdl->paceLost++;
+
+    M76_TRC_LEAVE(llHdl->ma);
+}
+
+/********************************* PaceRead *********************************
+ *
+ *  Description: Read queued records of paced sampling, wait for 
+ *               M76_PACE_WMARK records or a full buffer unless
+ *               non-blocking. Adds the records to the statistics and
+ *               checks the alarm limits.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl        low-level handle 
+ *               rec          record buffer
+ *               size         buffer size [bytes]
+ *  Output.....: nbrRdBytesP  number of read bytes
+ *               return       success (0), M76_ERR_NODATA or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 PaceRead(                          /* nodoc */
+    LL_HANDLE *llHdl,
+    M76_PACE_REC *rec,
+    int32 size,
+    int32 *nbrRdBytesP)
+{
+    u_int32 max = (u_int32)size / sizeof(M76_PACE_REC), want, n, i;
+    u_int32 wrap = 2 * llHdl->paceSize;
+    PACE_REC *q;
+    int32 error;
+
+    *nbrRdBytesP = 0;
+    if (max == 0)
+        return(ERR_LL_USERBUF);
+
+    want = llHdl->nbOn ? 1 : (max < llHdl->paceWmark ? max : llHdl->paceWmark);
+    while ((llHdl->pacePut + wrap - llHdl->paceGet) % wrap < want)  {
+        if (llHdl->nbOn)
+            return(M76_ERR_NODATA);
+        error = OSS_SemWait(llHdl->osHdl, llHdl->readSem,
+                            llHdl->pacePeriod + PACE_TOUT);
+        if (error)  {
+            llHdl->acq.semTout++;
+            EVT(llHdl, M76_EV_SEM_TOUT, error, COM_DATA);
+            return(error);
+        }
+    }
+
+    n = (llHdl->pacePut + wrap - llHdl->paceGet) % wrap;
+    if (n > max)
+        n = max;
+    for (i=0; i<n; i++, rec++)  {
+        q = &llHdl->paceBuf[(llHdl->paceGet + i) % llHdl->paceSize];
+        rec->value = q->value;
+        rec->seq   = q->seq;
+        rec->time  = q->time;
+
+        if (llHdl->statOn)
+            StatAdd(llHdl, q->value);
+        if (llHdl->almOn)
+            AlmCheck(llHdl, q->value);
+    }
+    llHdl->paceGet = (llHdl->paceGet + n) % wrap;
+
+    *nbrRdBytesP = n * sizeof(M76_PACE_REC);
+    return(ERR_SUCCESS);
+}
+
+/********************************* FmtStatus ********************************
+ *
+ *  Description: Status of raw code for M76_FMT_STATUS.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               x          raw 24-bit code (low byte 0 in M76_FAST mode)
+ *  Output.....: return     M76_FMT_xxx bits and range in upper byte
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 FmtStatus(LL_HANDLE *llHdl, int32 x)  /* nodoc */
+{
+    u_int32 st = llHdl->range << 24;
+
+    if (x == (llHdl->fast ? 0x00ffff00 : 0x00ffffff))
+        st |= M76_FMT_OVER;
+    else if (x == 0)
+        st |= M76_FMT_UNDER;
+    if (llHdl->checkSum == FALSE)
+        st |= M76_FMT_CALI_BAD;
+    return(st);
+}
+
+/********************************* FmtWords *********************************
+ *
+ *  Description: Convert raw codes in place to the sample format 
+ *               (M76_FORMAT). Packing runs forward, each code is read
+ *               before its bytes are overwritten.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               p          raw 24-bit codes
+ *               n          number of codes
+ *  Output.....: p          formatted samples
+ *               return     size of formatted samples [bytes]
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 FmtWords(LL_HANDLE *llHdl, int32 *p, u_int32 n)  /* nodoc */
+{
+    u_int8 *b = (u_int8*)p;
+    u_int32 i, x;
+
+    switch (llHdl->fmt)  {
+    case M76_FMT_STATUS:
+        for (i=0; i<n; i++)
+            p[i] |= FmtStatus(llHdl, p[i]);
+        break;
+    case M76_FMT_PACKED:
+        for (i=0; i<n; i++, b+=3)  {
+            x = p[i];
+            b[0] = (u_int8)(x >> 16);
+            b[1] = (u_int8)(x >> 8);
+            b[2] = (u_int8)x;
+        }
+        return(n * 3);
+    }
+    return(n * sizeof(int32));
+}
+
+/********************************* FilterPlc ********************************
+ *
+ *  Description: Get mains cycles per conversion of current filter word.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: return     mains cycles or 0 (not mains-synchronous)
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 FilterPlc(LL_HANDLE *llHdl)  /* nodoc */
+{
+    u_int32 x = llHdl->filFilter * llHdl->mainsHz;
+
+    return( (x % (FIL_FCLK / FIL_CLKDIV)) ? 0 : x / (FIL_FCLK / FIL_CLKDIV) );
+}
+
+/********************************* AdaptAdd *********************************
+ *
+ *  Description: Add conversion to noise estimate of noise-adaptive filter
+ *               and request a filter step if outside the hysteresis band.
+ *
+ *               var = sum(d^2) / (2 * 2^ADAPT_LD) of the differences d of
+ *               consecutive conversions. With 24-bit codes d^2 < 2^48,
+ *               the sum fits in 64 bit. Compared squared, no division.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               x          raw 24-bit code
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void AdaptAdd(LL_HANDLE *llHdl, int32 x)  /* nodoc */
+{
+    int64 d = x - llHdl->adaptLast;
+    u_int64 var, t2;
+    u_int16 fil = llHdl->filFilter;
+
+    llHdl->adaptLast = x;
+    if (llHdl->adaptCnt++ == 0)  {
+        llHdl->adaptSum = 0;
+        return;
+    }
+    llHdl->adaptSum += (u_int64)(d * d);
+    if (llHdl->adaptCnt <= (1 << ADAPT_LD))
+        return;
+
+    var = llHdl->adaptSum >> (ADAPT_LD + 1);
+    t2  = (u_int64)llHdl->adaptTarget * llHdl->adaptTarget;
+    llHdl->adaptNoise = Sqrt64(var);
+    llHdl->adaptCnt = 1;            /* continue with x */
+    llHdl->adaptSum = 0;
+
+    if ((var > t2) && (fil < FIL_MAX))
+        llHdl->adaptReq = (fil > FIL_MAX/2) ? FIL_MAX : fil * 2;
+    else if ((var * 4 < t2) && (fil > FIL_MIN))
+        llHdl->adaptReq = (fil < FIL_MIN*2) ? FIL_MIN : fil / 2;
+}
+
+/********************************* AdaptApply *******************************
+ *
+ *  Description: Set filter word requested by noise-adaptive filter.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void AdaptApply(LL_HANDLE *llHdl)  /* nodoc */
+{
+    llHdl->filFilter = llHdl->adaptReq;
+    EVT(llHdl, M76_EV_ADAPT, llHdl->filFilter, llHdl->adaptNoise);
+
+    WriteFilterReg(llHdl);
+    Settle(llHdl);                  /* clears adaptReq */
+    llHdl->pfCnt = 0;
+}
+
+/********************************* Sqrt64 ***********************************
+ *
+ *  Description: Integer square root by shift and subtract.
+ *---------------------------------------------------------------------------
+ *  Input......: x          radicand (< 2^64)
+ *  Output.....: return     floor(sqrt(x))
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 Sqrt64(u_int64 x)  /* nodoc */
+{
+    u_int64 r = 0, b = (u_int64)1 << 62;
+
+    while (b > x)
+        b >>= 2;
+    while (b)  {
+        if (x >= r + b)  {
+            x -= r + b;
+            r = (r >> 1) + b;
+        }
+        else
+            r >>= 1;
+        b >>= 2;
+    }
+    return((u_int32)r);
+}
+
+/********************************* ZcalSlot *********************************
+ *
+ *  Description: Background zero-scale self-calibration of current range
+ *               (voltage/current).
+ *
+ *               The self-calibration overwrites the zero-scale register,
+ *               afterwards the stored value (plus the drift since the 
+ *               base with M76_ZCAL_APPLY) is written back.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 ZcalSlot(LL_HANDLE *llHdl)  /* nodoc */
+{
+    int32 error, z, drift = 0;
+    u_int32 val;
+    u_int16 com, calH, calL;
+
+    error = CalibConv(llHdl, MOD_ZERO_SELF, COM_CALI_ZERO, &z);
+    if (error)  {
+        WriteModeReg(llHdl);        /* back to normal mode */
+        WriteCaliReg(llHdl);
+        return(error);
+    }
+    z &= 0x00ffffff;
+
+    if (!llHdl->zcalValid)  {
+        llHdl->zcalBase  = z;
+        llHdl->zcalValid = TRUE;
+    }
+    llHdl->zcalLast = z;
+    if (llHdl->zcalMode == M76_ZCAL_APPLY)
+        drift = ((int32)((u_int32)(z - llHdl->zcalBase) << 8)) >> 8;
+    val = (u_int32)(CaliVa(llHdl)->zero + drift) & 0x00ffffff;
+
+    com = (COM_CALI_ZERO | llHdl->comChan);
+    MWRITE_D16(llHdl->ma, COM_REG, com);
+    calH = (u_int16)(val >> 16);
+    MWRITE_D16(llHdl->ma, DATA_REG, calH);
+    calL = (u_int16)(val & 0xffff);
+    MWRITE_D16(llHdl->ma, DATA_REG+2, calL);
+    EVT(llHdl, M76_EV_COM, com, val);
+
+    llHdl->zcalApplied = val;
+    llHdl->zcalTime = M76_EVT_TIME(llHdl);
+    llHdl->zcalSlots++;
+    llHdl->zcalFlag = TRUE;
+    EVT(llHdl, M76_EV_ZCAL, z, z - llHdl->zcalBase);
+    return(0);
+}
+
+/********************************* CaliVa ***********************************
+ *
+ *  Description: Get calibration values of current voltage/current range
+ *               or custom range preset.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *  Output.....: return     calibration values
+ *  Globals....: -
+ ****************************************************************************/
+static CALI_VA *CaliVa(LL_HANDLE *llHdl)  /* nodoc */
+{
+    if (llHdl->range >= RANGE_NUM)
+        return(&llHdl->user[llHdl->range - RANGE_NUM].cali);
+
+    return(&llHdl->caliVals.dcV[0] + llHdl->range);
+}
+
+/********************************* UserRangeDef *****************************
+ *
+ *  Description: Check and set custom range preset.
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               def        preset
+ *  Output.....: return     success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 UserRangeDef(LL_HANDLE *llHdl, M76_RANGE_DEF *def)  /* nodoc */
+{
+    USER_RANGE *u;
+
+    if ((def->range < RANGE_NUM) || (def->range >= RANGE_MAX) ||
+        (def->chan > 7) || (def->gain > 7) || (def->unipolar > 1) ||
+        (def->filter && ((def->filter < FIL_MIN) || (def->filter > FIL_MAX))))
+        return(ERR_LL_ILL_PARAM);
+
+    u = &llHdl->user[def->range - RANGE_NUM];
+    u->config    = def->config;
+    u->comChan   = def->chan;
+    u->modGain   = (u_int16)(def->gain << 2);
+    u->polarity  = def->unipolar ? FHI_POLAR_UNI : FHI_POLAR_BI;
+    u->filter    = def->filter;
+    u->settle    = def->settle;
+    u->cali.zero = def->caliZero;
+    u->cali.full = def->caliFull;
+    u->defined   = TRUE;
+    return(0);
+}
+
+/* descriptor keys of custom range preset (RANGE_USER_<n>/<key>) */
+static const struct {
+    char        *key;
+    u_int32     def;
+} G_userKey[USER_KEYS] = {
+    { "CONFIG",     0           },      /* required */
+    { "CHAN",       COM_DC      },
+    { "GAIN",       0           },
+    { "UNIPOLAR",   0           },
+    { "FILTER",     0           },
+    { "SETTLE",     0           },
+    { "CALI_ZERO",  0xffffffff  },
+    { "CALI_FULL",  0xffffffff  }
+};
+
+/********************************* UserRangeDesc ****************************
+ *
+ *  Description: Get custom range preset from descriptor (RANGE_USER_<n>).
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl      low-level handle 
+ *               n          preset number
+ *  Output.....: return     success (0, also if not defined) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 UserRangeDesc(LL_HANDLE *llHdl, u_int32 n)  /* nodoc */
+{
+    M76_RANGE_DEF def;
+    u_int32 v[USER_KEYS], i;
+    int32 error;
+
+    for (i=0; i<USER_KEYS; i++)  {
+        error = DESC_GetUInt32(llHdl->descHdl, G_userKey[i].def, &v[i],
+                               "RANGE_USER_%d/%s", n, G_userKey[i].key);
+        if (error == ERR_DESC_KEY_NOTFOUND)  {
+            if (i == 0)
+                return(0);          /* not defined */
+        }
+        else if (error)
+            return(error);
+    }
+
+    def.range    = M76_RANGE_USER(n);
+    def.config   = v[0];
+    def.chan     = (u_int16)v[1];
+    def.gain     = (u_int16)v[2];
+    def.unipolar = (u_int16)v[3];
+    def.filter   = (u_int16)v[4];
+    def.settle   = v[5];
+    def.caliZero = (int32)v[6];
+    def.caliFull = (int32)v[7];
+
+    if ((v[1] > 0xffff) || (v[2] > 0xffff) || (v[3] > 0xffff) || 
+        (v[4] > 0xffff))
+        return(ERR_LL_ILL_PARAM);
+    return(UserRangeDef(llHdl, &def));
+}
+
+#ifdef M76_TRACE
+/********************************* TrcInit **********************************
+ *
+ *  Description: Traced M76_Init: allocate trace and call M76_Init.
+ *---------------------------------------------------------------------------
+ *  Input......: see M76_Init
+ *  Output.....: see M76_Init
+ *  Globals....: -
+ ****************************************************************************/
+static int32 TrcInit(                                   /* nodoc */
+    DESC_SPEC       *descP,
+    OSS_HANDLE      *osHdl,
+    MACCESS         *ma,
+    OSS_SEM_HANDLE  *devSemHdl,
+    OSS_IRQ_HANDLE  *irqHdl,
+    LL_HANDLE       **llHdlP
+)
+{
+    M76_TRC *trc;
+    u_int32 gotsize;
+    int32 error;
+
+    if ((trc = __M76_TrcCreate(osHdl, *ma, &gotsize)) == NULL)
+        return(ERR_OSS_MEM_ALLOC);
+
+    M76_TRC_ENTRY(*ma, M76_TRC_SC_INIT);
+    error = M76_Init(descP, osHdl, ma, devSemHdl, irqHdl, llHdlP);
+    M76_TRC_LEAVE(*ma);
+
+    if (error)  {
+        __M76_TrcDelete(trc, gotsize);
+        return(error);
+    }
+    (*llHdlP)->trc      = trc;
+    (*llHdlP)->trcAlloc = gotsize;
+    return(ERR_SUCCESS);
+}
+
+/********************************* TrcExit **********************************
+ *
+ *  Description: Traced M76_Exit: call M76_Exit and free trace.
+ *---------------------------------------------------------------------------
+ *  Input......: see M76_Exit
+ *  Output.....: see M76_Exit
+ *  Globals....: -
+ ****************************************************************************/
+static int32 TrcExit(LL_HANDLE **llHdlP)               /* nodoc */
+{
+    MACCESS ma        = (*llHdlP)->ma;
+    M76_TRC *trc      = (*llHdlP)->trc;
+    u_int32 trcAlloc  = (*llHdlP)->trcAlloc;
+    int32 error;
+
+    M76_TRC_ENTRY(ma, M76_TRC_SC_EXIT);
+    error = M76_Exit(llHdlP);
+    M76_TRC_LEAVE(ma);
+
+    __M76_TrcDelete(trc, trcAlloc);
+    return(error);
+}
+
+/***************************** Trc<EntryPoint> ******************************
+ *
+ *  Description: Traced entry points: open scope of entry point and call it.
+ *---------------------------------------------------------------------------
+ *  Input......: see M76_<EntryPoint>
+ *  Output.....: see M76_<EntryPoint>
+ *  Globals....: -
+ ****************************************************************************/
+static int32 TrcRead(LL_HANDLE *llHdl, int32 ch, int32 *value)  /* nodoc */
+{
+    int32 error;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_READ);
+    error = M76_Read(llHdl, ch, value);
+    M76_TRC_LEAVE(llHdl->ma);
+    return(error);
+}
+
+static int32 TrcWrite(LL_HANDLE *llHdl, int32 ch, int32 value)  /* nodoc */
+{
+    int32 error;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_WRITE);
+    error = M76_Write(llHdl, ch, value);
+    M76_TRC_LEAVE(llHdl->ma);
+    return(error);
+}
+
+static int32 TrcSetStat(                                /* nodoc */
+    LL_HANDLE   *llHdl,
+    int32       code,
+    int32       ch,
+    INT32_OR_64 value32_or_64
+)
+{
+    int32 error;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_SETSTAT);
+    error = M76_SetStat(llHdl, code, ch, value32_or_64);
+    M76_TRC_LEAVE(llHdl->ma);
+    return(error);
+}
+
+static int32 TrcGetStat(                                /* nodoc */
+    LL_HANDLE   *llHdl,
+    int32       code,
+    int32       ch,
+    INT32_OR_64 *value32_or_64P
+)
+{
+    int32 error;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_GETSTAT);
+    error = M76_GetStat(llHdl, code, ch, value32_or_64P);
+    M76_TRC_LEAVE(llHdl->ma);
+    return(error);
+}
+
+static int32 TrcBlockRead(                              /* nodoc */
+    LL_HANDLE   *llHdl,
+    int32       ch,
+    void        *buf,
+    int32       size,
+    int32       *nbrRdBytesP
+)
+{
+    int32 error;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_BLKREAD);
+    error = M76_BlockRead(llHdl, ch, buf, size, nbrRdBytesP);
+    M76_TRC_LEAVE(llHdl->ma);
+    return(error);
+}
+
+static int32 TrcBlockWrite(                             /* nodoc */
+    LL_HANDLE   *llHdl,
+    int32       ch,
+    void        *buf,
+    int32       size,
+    int32       *nbrWrBytesP
+)
+{
+    int32 error;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_BLKWRITE);
+    error = M76_BlockWrite(llHdl, ch, buf, size, nbrWrBytesP);
+    M76_TRC_LEAVE(llHdl->ma);
+    return(error);
+}
+
+static int32 TrcIrq(LL_HANDLE *llHdl)                   /* nodoc */
+{
+    int32 ret;
+
+    M76_TRC_ENTRY(llHdl->ma, M76_TRC_SC_IRQ);
+    ret = M76_Irq(llHdl);
+    M76_TRC_LEAVE(llHdl->ma);
+    return(ret);
+}
+#endif /* M76_TRACE */
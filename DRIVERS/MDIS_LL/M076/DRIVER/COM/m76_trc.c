@@ -0,0 +1,379 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************
+ *
+ *         Name: m76_trc.c
+ *      Project: M76 ll-driver
+ *
+ *  Description: M76 bus access tracer (switch M76_TRACE)
+ *
+ *               Counts register accesses and delays of the driver per
+ *               scope and optionally logs them into a ring (M76_TRC).
+ *               Each device has its own trace handle, created by
+ *               M76_TrcCreate() and found by the hardware access handle
+ *               (delays: by the OSS handle). Scopes form a stack per
+ *               device: M76_TRC_ENTRY() at an entry point or alarm opens
+ *               the scope of the entry point, M76_TRC_ENTER() in a helper
+ *               opens a nested scope. An access is counted for the
+ *               innermost scope and for the entry point.
+ *
+ *               Interrupts nest like calls. Debug build only, not SMP safe.
+ *
+ *     Required: -
+ *     Switches: M76_TRACE
+ *
+ *---------------------------[ Public Functions ]----------------------------
+ *  M76_TrcCreate, M76_TrcDelete, M76_TrcEntry, M76_TrcEnter,
+ *  M76_TrcLeave, M76_TrcRead16, M76_TrcWrite16, M76_TrcDelay,
+ *  M76_TrcMikroDelay
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+ ****************************************************************************/
+
+#define _M76_TRC_C          /* m76_trc.h: keep real accesses */
+
+#include <MEN/men_typs.h>
+#include <MEN/maccess.h>
+#include <MEN/oss.h>
+#include <MEN/desc.h>
+#include <MEN/mdis_api.h>
+#include <MEN/ll_defs.h>
+#include <MEN/ll_entry.h>
+#include <MEN/m76_drv.h>
+
+#include "m76_uee.h"
+#include "m76_trc.h"
+
+#ifdef M76_TRACE
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define TRC_DEPTH           8           /* max. recorded scope nesting */
+#define TRC_DEVS            8           /* max. traced devices */
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+typedef struct {
+    u_int32     entry;          /* scope of entry point */
+    u_int32     scope;          /* innermost scope */
+} TRC_FRAME;
+
+typedef struct {
+    M76_TRC     trc;            /* trace (M76_BLK_TRC), must be first */
+    OSS_HANDLE  *osh;           /* OSS handle of device */
+    MACCESS     ma;             /* hardware access handle of device */
+    u_int32     depth;          /* open scopes (may exceed TRC_DEPTH) */
+    TRC_FRAME   stack[TRC_DEPTH];
+} TRC_HDL;
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+static TRC_HDL *G_dev[TRC_DEVS];    /* traced devices */
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+static TRC_HDL *FindMa(MACCESS ma);
+static TRC_HDL *FindOsh(OSS_HANDLE *osh);
+static void Push(TRC_HDL *h, u_int32 entry, u_int32 scope);
+static void Count(TRC_HDL *h, u_int32 op, u_int32 offs, u_int32 val,
+                  u_int32 us);
+
+/******************************* M76_TrcCreate ******************************
+ *
+ *  Description:  Create trace handle of device.
+ *
+ *                If more than TRC_DEVS devices are traced, the accesses
+ *                of the additional devices are not counted.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  osh      OSS handle
+ *                ma       hardware access handle
+ *  Output.....:  *allocP  allocated size
+ *                return   trace (NULL: no memory)
+ *  Globals....:  G_dev
+ ****************************************************************************/
+M76_TRC *__M76_TrcCreate(OSS_HANDLE *osh, MACCESS ma, u_int32 *allocP)
+{
+    TRC_HDL *h;
+    u_int32 i;
+
+    if ((h = (TRC_HDL*)OSS_MemGet(osh, sizeof(TRC_HDL), allocP)) == NULL)
+        return(NULL);
+    OSS_MemFill(osh, *allocP, (char*)h, 0x00);
+    h->osh = osh;
+    h->ma  = ma;
+
+    for (i=0; i<TRC_DEVS; i++)  {
+        if (G_dev[i] == NULL)  {
+            G_dev[i] = h;
+            break;
+        }
+    }
+    return(&h->trc);
+}
+
+/******************************* M76_TrcDelete ******************************
+ *
+ *  Description:  Delete trace handle of device.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  trc      trace from M76_TrcCreate()
+ *                alloc    allocated size
+ *  Output.....:  -
+ *  Globals....:  G_dev
+ ****************************************************************************/
+void __M76_TrcDelete(M76_TRC *trc, u_int32 alloc)
+{
+    TRC_HDL *h = (TRC_HDL*)trc;
+    u_int32 i;
+
+    for (i=0; i<TRC_DEVS; i++)
+        if (G_dev[i] == h)
+            G_dev[i] = NULL;
+
+    OSS_MemFree(h->osh, (int8*)h, alloc);
+}
+
+/******************************* M76_TrcEntry *******************************
+ *
+ *  Description:  Open scope of entry point or alarm routine.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma       hardware access handle
+ *                scope    M76_TRC_SC_xxx
+ *  Output.....:  -
+ *  Globals....:  -
+ ****************************************************************************/
+void __M76_TrcEntry(MACCESS ma, u_int32 scope)
+{
+    TRC_HDL *h = FindMa(ma);
+
+    if (h)
+        Push(h, scope, scope);
+}
+
+/******************************* M76_TrcEnter *******************************
+ *
+ *  Description:  Open nested scope of helper.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma       hardware access handle
+ *                scope    M76_TRC_SC_xxx
+ *  Output.....:  -
+ *  Globals....:  -
+ ****************************************************************************/
+void __M76_TrcEnter(MACCESS ma, u_int32 scope)
+{
+    TRC_HDL *h = FindMa(ma);
+
+    if (h == NULL)
+        return;
+    if (h->depth == 0)  {
+        Push(h, scope, scope);
+        return;
+    }
+    Push(h, h->stack[(h->depth > TRC_DEPTH ? TRC_DEPTH : h->depth) - 1].entry,
+         scope);
+}
+
+/******************************* M76_TrcLeave *******************************
+ *
+ *  Description:  Close innermost scope.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma       hardware access handle
+ *  Output.....:  -
+ *  Globals....:  -
+ ****************************************************************************/
+void __M76_TrcLeave(MACCESS ma)
+{
+    TRC_HDL *h = FindMa(ma);
+
+    if (h && h->depth)
+        h->depth--;
+}
+
+/******************************* M76_TrcRead16 ******************************
+ *
+ *  Description:  Traced MREAD_D16.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma       hardware access handle
+ *                offs     register offset
+ *  Output.....:  return   register value
+ *  Globals....:  -
+ ****************************************************************************/
+u_int16 __M76_TrcRead16(MACCESS ma, u_int32 offs)
+{
+    u_int16 val = MREAD_D16(ma, offs);
+
+    Count(FindMa(ma), M76_TRC_OP_READ, offs, val, 0);
+    return(val);
+}
+
+/******************************* M76_TrcWrite16 *****************************
+ *
+ *  Description:  Traced MWRITE_D16.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma       hardware access handle
+ *                offs     register offset
+ *                val      value
+ *  Output.....:  -
+ *  Globals....:  -
+ ****************************************************************************/
+void __M76_TrcWrite16(MACCESS ma, u_int32 offs, u_int16 val)
+{
+    MWRITE_D16(ma, offs, val);
+    Count(FindMa(ma), M76_TRC_OP_WRITE, offs, val, 0);
+}
+
+/******************************* M76_TrcDelay *******************************
+ *
+ *  Description:  Traced OSS_Delay.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  osh      OSS handle
+ *                msec     delay [msec]
+ *  Output.....:  return   see OSS_Delay
+ *  Globals....:  -
+ ****************************************************************************/
+int32 __M76_TrcDelay(OSS_HANDLE *osh, int32 msec)
+{
+    Count(FindOsh(osh), M76_TRC_OP_DELAY, 0, (u_int32)msec,
+          (u_int32)msec * 1000);
+    return( OSS_Delay(osh, msec) );
+}
+
+/****************************** M76_TrcMikroDelay ***************************
+ *
+ *  Description:  Traced OSS_MikroDelay.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  osh      OSS handle
+ *                usec     delay [usec]
+ *  Output.....:  return   see OSS_MikroDelay
+ *  Globals....:  -
+ ****************************************************************************/
+int32 __M76_TrcMikroDelay(OSS_HANDLE *osh, u_int32 usec)
+{
+    Count(FindOsh(osh), M76_TRC_OP_UDELAY, 0, usec, usec);
+    return( OSS_MikroDelay(osh, usec) );
+}
+
+/********************************* FindMa ***********************************
+ *
+ *  Description:  Find trace handle by hardware access handle.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  ma       hardware access handle
+ *  Output.....:  return   trace handle (NULL: device not traced)
+ *  Globals....:  G_dev
+ ****************************************************************************/
+static TRC_HDL *FindMa(MACCESS ma) /* nodoc */
+{
+    u_int32 i;
+
+    for (i=0; i<TRC_DEVS; i++)
+        if (G_dev[i] && (G_dev[i]->ma == ma))
+            return(G_dev[i]);
+    return(NULL);
+}
+
+/********************************* FindOsh **********************************
+ *
+ *  Description:  Find trace handle with open scope by OSS handle.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  osh      OSS handle
+ *  Output.....:  return   trace handle (NULL: none)
+ *  Globals....:  G_dev
+ ****************************************************************************/
+static TRC_HDL *FindOsh(OSS_HANDLE *osh) /* nodoc */
+{
+    u_int32 i;
+
+    for (i=0; i<TRC_DEVS; i++)
+        if (G_dev[i] && (G_dev[i]->osh == osh) && G_dev[i]->depth)
+            return(G_dev[i]);
+    return(NULL);
+}
+
+/********************************* Push *************************************
+ *
+ *  Description:  Open scope and count call.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  h        trace handle
+ *                entry    scope of entry point
+ *                scope    innermost scope
+ *  Output.....:  -
+ *  Globals....:  -
+ ****************************************************************************/
+static void Push(TRC_HDL *h, u_int32 entry, u_int32 scope) /* nodoc */
+{
+    if (h->depth < TRC_DEPTH)  {
+        h->stack[h->depth].entry = entry;
+        h->stack[h->depth].scope = scope;
+    }
+    h->depth++;
+
+    if (scope < M76_TRC_SCOPES)
+        h->trc.cnt[scope].calls++;
+}
+
+/********************************* Count ************************************
+ *
+ *  Description:  Count access/delay for innermost scope and entry point
+ *                and log it.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  h        trace handle (NULL: not traced)
+ *                op       M76_TRC_OP_xxx
+ *                offs     register offset
+ *                val      value or delay
+ *                us       delay [usec]
+ *  Output.....:  -
+ *  Globals....:  -
+ ****************************************************************************/
+static void Count(TRC_HDL *h, u_int32 op, u_int32 offs, u_int32 val,
+                  u_int32 us) /* nodoc */
+{
+    TRC_FRAME *f;
+    M76_TRC_CNT *c;
+    M76_TRC_ACC *a;
+    u_int32 i, scope;
+
+    if ((h == NULL) || (h->depth == 0))
+        return;
+    f = &h->stack[(h->depth > TRC_DEPTH ? TRC_DEPTH : h->depth) - 1];
+    if (f->scope >= M76_TRC_SCOPES)
+        return;
+
+    for (i=0, scope=f->scope; i<2; i++, scope=f->entry)  {
+        c = &h->trc.cnt[scope];
+        switch (op)  {
+        case M76_TRC_OP_READ:   c->reads++;     break;
+        case M76_TRC_OP_WRITE:  c->writes++;    break;
+        default:
+            c->delays++;
+            c->delayUs += us;
+        }
+        if (f->entry == f->scope)
+            break;
+    }
+
+    if (h->trc.logOn)  {
+        a = &h->trc.log[h->trc.logCnt % M76_TRC_LOG_SIZE];
+        a->scope = (u_int8)f->scope;
+        a->op    = (u_int8)op;
+        a->offs  = (u_int16)offs;
+        a->val   = val;
+        h->trc.logCnt++;
+    }
+}
+
+#endif /* M76_TRACE */
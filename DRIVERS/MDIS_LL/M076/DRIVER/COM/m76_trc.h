@@ -0,0 +1,84 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: m76_trc.h
+ *
+ *  Description: Internal include file for M76 bus access tracer
+ *
+ *               With switch M76_TRACE, MREAD_D16/MWRITE_D16 and
+ *               OSS_Delay/OSS_MikroDelay of the including file are
+ *               redirected to the tracer, which counts them for the
+ *               current scope (M76_TRC_ENTRY/M76_TRC_ENTER) of the device
+ *               and logs them if enabled. The device is identified by its
+ *               hardware access handle (ma), delays by its OSS handle.
+ *               Without M76_TRACE all macros are empty.
+ *
+ *               Must be included after maccess.h, oss.h and m76_uee.h.
+ *
+ *     Switches: M76_TRACE
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+ ****************************************************************************/
+
+#ifndef _M76_TRC_H
+#define _M76_TRC_H
+
+#ifdef __cplusplus
+      extern "C" {
+#endif
+
+#define __M76_TrcCreate     M76_GLOBNAME(M76_VARIANT,TrcCreate)
+#define __M76_TrcDelete     M76_GLOBNAME(M76_VARIANT,TrcDelete)
+#define __M76_TrcEntry      M76_GLOBNAME(M76_VARIANT,TrcEntry)
+#define __M76_TrcEnter      M76_GLOBNAME(M76_VARIANT,TrcEnter)
+#define __M76_TrcLeave      M76_GLOBNAME(M76_VARIANT,TrcLeave)
+#define __M76_TrcRead16     M76_GLOBNAME(M76_VARIANT,TrcRead16)
+#define __M76_TrcWrite16    M76_GLOBNAME(M76_VARIANT,TrcWrite16)
+#define __M76_TrcDelay      M76_GLOBNAME(M76_VARIANT,TrcDelay)
+#define __M76_TrcMikroDelay M76_GLOBNAME(M76_VARIANT,TrcMikroDelay)
+
+#ifdef M76_TRACE
+
+struct m76_trc;
+
+/* tracer prototypes */
+extern struct m76_trc *__M76_TrcCreate(OSS_HANDLE *osh, MACCESS ma,
+                                       u_int32 *allocP);
+extern void    __M76_TrcDelete(struct m76_trc *trc, u_int32 alloc);
+extern void    __M76_TrcEntry(MACCESS ma, u_int32 scope);
+extern void    __M76_TrcEnter(MACCESS ma, u_int32 scope);
+extern void    __M76_TrcLeave(MACCESS ma);
+extern u_int16 __M76_TrcRead16(MACCESS ma, u_int32 offs);
+extern void    __M76_TrcWrite16(MACCESS ma, u_int32 offs, u_int16 val);
+extern int32   __M76_TrcDelay(OSS_HANDLE *osh, int32 msec);
+extern int32   __M76_TrcMikroDelay(OSS_HANDLE *osh, u_int32 usec);
+
+# ifndef _M76_TRC_C     /* the tracer itself uses the real accesses */
+#  undef  MREAD_D16
+#  undef  MWRITE_D16
+#  undef  OSS_Delay
+#  undef  OSS_MikroDelay
+#  define MREAD_D16(ma,offs)        __M76_TrcRead16((ma),(offs))
+#  define MWRITE_D16(ma,offs,val)   __M76_TrcWrite16((ma),(offs),(u_int16)(val))
+#  define OSS_Delay(osh,msec)       __M76_TrcDelay((osh),(msec))
+#  define OSS_MikroDelay(osh,usec)  __M76_TrcMikroDelay((osh),(usec))
+# endif
+
+/* entry point/alarm: scope of entry point, helper: nested scope */
+# define M76_TRC_ENTRY(ma,scope)    __M76_TrcEntry((ma),(scope))
+# define M76_TRC_ENTER(ma,scope)    __M76_TrcEnter((ma),(scope))
+# define M76_TRC_LEAVE(ma)          __M76_TrcLeave(ma)
+
+#else
+
+# define M76_TRC_ENTRY(ma,scope)
+# define M76_TRC_ENTER(ma,scope)
+# define M76_TRC_LEAVE(ma)
+
+#endif /* M76_TRACE */
+
+#ifdef __cplusplus
+      }
+#endif
+
+#endif /* _M76_TRC_H */
@@ -12,10 +12,11 @@
  *                      
  *                      
  *     Required:  
- *     Switches:  
+ *     Switches: M76_TRACE (bus access tracer, see m76_trc.h)
  *
  *---------------------------[ Public Functions ]----------------------------
- *  M76_UeeRead, M76_UeeWrite
+ *  M76_UeeRead, M76_UeeWrite, M76_UeeEraseStart, M76_UeeWriteStart,
+ *  M76_UeeReady, M76_UeeFinish
  *  
  *-------------------------------[ History ]---------------------------------
  *
@@ -39,6 +40,7 @@
 #include <MEN/maccess.h>
 
 #include "m76_uee.h"
+#include "m76_trc.h"
 
 /*--- instructions for serial EEPROM ---*/
 #define     OPSH    2
@@ -115,6 +117,95 @@ extern int32 __M76_UeeRead(OSS_HANDLE *osh, MACCESS ma, u_int8 index ) /* nodoc
 }
 
 
+/******************************* M76_UeeEraseStart **************************
+ *
+ *  Description:  Start erasing a word in EEPROM, don't wait for completion.
+ *
+ *                Poll M76_UeeReady() until erase cycle is complete, then 
+ *                call M76_UeeFinish().
+ *---------------------------------------------------------------------------
+ *  Input......:  osh      oss handle
+ *                ma       hardware access handle
+ *                index    index to erase
+ *  Output.....:  -
+ *  Globals....:  ---
+ ***************************************************************************/
+extern void __M76_UeeEraseStart(OSS_HANDLE *osh, MACCESS ma, u_int8 index ) /* nodoc */
+{
+    _opcode(osh, ma,EWEN);                /* erase enable */
+    _deselect(ma);                        /* deselect     */
+
+    _opcode(osh,ma,(ERASE+index) );        /* select erase */
+    _deselect(ma);                        /* deselect     */
+
+    _select(osh,ma);                      /* DO shows busy */
+}
+
+/******************************* M76_UeeWriteStart **************************
+ *
+ *  Description:  Start writing a word into EEPROM, don't wait for completion.
+ *                The cell must have been erased before.
+ *
+ *                Poll M76_UeeReady() until write cycle is complete, then 
+ *                call M76_UeeFinish() and verify with M76_UeeRead().
+ *---------------------------------------------------------------------------
+ *  Input......:  osh      oss handle
+ *                ma       hardware access handle
+ *                index    index to write
+ *                data     word to write
+ *  Output.....:  -
+ *  Globals....:  ---
+ ***************************************************************************/
+extern void __M76_UeeWriteStart                     /* nodoc */
+(OSS_HANDLE *osh, MACCESS ma, u_int8 index, u_int16 data )
+{
+    register int    i;                      /* counter      */
+
+    _opcode(osh,ma,EWEN);                     /* write enable */
+    _deselect(ma);                        /* deselect     */
+
+    _opcode(osh,ma, (_WRITE_+index) );             /* select write */
+    for(i=15; i>=0; i--)
+        _clock(osh,ma,(u_int8)((data>>i)&0x01));        /* write data   */
+    _deselect(ma);                        /* deselect     */
+
+    _select(osh,ma);                      /* DO shows busy */
+}
+
+/******************************* M76_UeeReady *******************************
+ *
+ *  Description:  Check if erase/write cycle started with M76_UeeEraseStart()
+ *                or M76_UeeWriteStart() is complete.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  osh      oss handle
+ *                ma       hardware access handle
+ *  Output.....:  return   0=busy 1=ready
+ *  Globals....:  ---
+ ***************************************************************************/
+extern int32 __M76_UeeReady(OSS_HANDLE *osh, MACCESS ma ) /* nodoc */
+{
+    return( _clock(osh,ma,0) ? 1 : 0 );
+}
+
+/******************************* M76_UeeFinish ******************************
+ *
+ *  Description:  Disable erase/write state and deselect EEPROM after 
+ *                M76_UeeEraseStart() or M76_UeeWriteStart().
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  osh      oss handle
+ *                ma       hardware access handle
+ *  Output.....:  -
+ *  Globals....:  ---
+ ***************************************************************************/
+extern void __M76_UeeFinish(OSS_HANDLE *osh, MACCESS ma ) /* nodoc */
+{
+    _opcode(osh,ma, EWDS);                /* write disable*/
+    _deselect(ma);                        /* disable      */
+}
+
+
 /******************************* _write ************************************
  *
  *  Description:  Write a specified word into EEPROM at 'ma'.
@@ -46,12 +46,22 @@
 
 #define __M76_UeeRead      M76_GLOBNAME(M76_VARIANT,UeeRead)
 #define __M76_UeeWrite     M76_GLOBNAME(M76_VARIANT,UeeWrite)
+#define __M76_UeeEraseStart M76_GLOBNAME(M76_VARIANT,UeeEraseStart)
+#define __M76_UeeWriteStart M76_GLOBNAME(M76_VARIANT,UeeWriteStart)
+#define __M76_UeeReady     M76_GLOBNAME(M76_VARIANT,UeeReady)
+#define __M76_UeeFinish    M76_GLOBNAME(M76_VARIANT,UeeFinish)
 
 
 /* calibration eeprom access prototypes */
 extern int32 __M76_UeeRead(OSS_HANDLE *osh, MACCESS ma, u_int8 index );
 extern int32 __M76_UeeWrite(OSS_HANDLE *osh, MACCESS ma, u_int8 index, u_int16 data );
 
+/* non-blocking erase/write: start, poll __M76_UeeReady, then __M76_UeeFinish */
+extern void __M76_UeeEraseStart(OSS_HANDLE *osh, MACCESS ma, u_int8 index );
+extern void __M76_UeeWriteStart(OSS_HANDLE *osh, MACCESS ma, u_int8 index, u_int16 data );
+extern int32 __M76_UeeReady(OSS_HANDLE *osh, MACCESS ma );
+extern void __M76_UeeFinish(OSS_HANDLE *osh, MACCESS ma );
+
 #ifdef __cplusplus
       }
 #endif
@@ -0,0 +1,41 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: dbg.h
+ *
+ *  Description: Host simulation: debug macros, output to stderr
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _DBG_H
+#define _DBG_H
+
+#define DBG_LEV1        0x00000001
+#define DBG_LEV2        0x00000002
+#define DBG_LEV3        0x00000004
+#define DBG_LEVERR      0x00008000
+#define DBG_NORM        0x40000000
+#define DBG_INTR        0x80000000
+
+typedef struct DBG_HANDLE DBG_HANDLE;
+
+extern int32 DBG_Init(char *name, DBG_HANDLE **dbgP);
+extern int32 DBG_Exit(DBG_HANDLE **dbgP);
+extern int32 DBG_Write(DBG_HANDLE *dbg, char *fmt, ...);
+
+#define _DBG_WRT(_lev_,_x_) \
+    do { if ((DBG_MYLEVEL & (_lev_)) == (_lev_)) DBG_Write _x_; } while(0)
+
+#define DBGINIT(_x_)        DBG_Init _x_
+#define DBGEXIT(_x_)        DBG_Exit _x_
+#define DBGWRT_1(_x_)       _DBG_WRT(DBG_NORM|DBG_LEV1,_x_)
+#define DBGWRT_2(_x_)       _DBG_WRT(DBG_NORM|DBG_LEV2,_x_)
+#define DBGWRT_3(_x_)       _DBG_WRT(DBG_NORM|DBG_LEV3,_x_)
+#define DBGWRT_ERR(_x_)     _DBG_WRT(DBG_NORM|DBG_LEVERR,_x_)
+#define IDBGWRT_1(_x_)      _DBG_WRT(DBG_INTR|DBG_LEV1,_x_)
+#define IDBGWRT_2(_x_)      _DBG_WRT(DBG_INTR|DBG_LEV2,_x_)
+#define IDBGWRT_3(_x_)      _DBG_WRT(DBG_INTR|DBG_LEV3,_x_)
+#define IDBGWRT_ERR(_x_)    _DBG_WRT(DBG_INTR|DBG_LEVERR,_x_)
+
+#endif /* _DBG_H */
@@ -0,0 +1,36 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: desc.h
+ *
+ *  Description: Host simulation: descriptor access
+ *               A descriptor is a NULL terminated SIM_DESC_ENTRY table.
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _DESC_H
+#define _DESC_H
+
+typedef struct {
+    const char  *key;       /* key name, NULL terminates table */
+    u_int32     value;      /* value of U_INT32 key */
+    const u_int8 *bin;      /* data of BINARY key (or NULL) */
+    u_int32     binLen;     /* length of BINARY key */
+} SIM_DESC_ENTRY;
+
+typedef SIM_DESC_ENTRY DESC_SPEC;
+typedef struct DESC_HANDLE DESC_HANDLE;
+
+extern int32 DESC_Init(DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
+                       DESC_HANDLE **descHdlP);
+extern int32 DESC_Exit(DESC_HANDLE **descHdlP);
+extern int32 DESC_GetUInt32(DESC_HANDLE *descHdl, u_int32 defVal,
+                            u_int32 *valueP, char *keyFmt, ...);
+extern int32 DESC_GetBinary(DESC_HANDLE *descHdl, u_int8 *defVal,
+                            u_int32 defLen, u_int8 *buf, u_int32 *lenP,
+                            char *keyFmt, ...);
+extern int32 DESC_DbgLevelSet(DESC_HANDLE *descHdl, u_int32 dbgLevel);
+extern char  *DESC_Ident(void);
+
+#endif /* _DESC_H */
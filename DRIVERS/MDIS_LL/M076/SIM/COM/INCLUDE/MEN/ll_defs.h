@@ -0,0 +1,37 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: ll_defs.h
+ *
+ *  Description: Host simulation: low-level driver definitions
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _LL_DEFS_H
+#define _LL_DEFS_H
+
+#include <stdarg.h>
+
+/* M_Irq return codes */
+#define LL_IRQ_DEVICE           0
+#define LL_IRQ_DEV_NOT          1
+#define LL_IRQ_UNKNOWN          2
+
+/* M_Info codes */
+#define LL_INFO_HW_CHARACTER    1
+#define LL_INFO_ADDRSPACE_COUNT 2
+#define LL_INFO_ADDRSPACE       3
+#define LL_INFO_IRQ             4
+#define LL_INFO_LOCKMODE        5
+
+/* lock modes */
+#define LL_LOCK_NONE            0
+#define LL_LOCK_CALL            1
+#define LL_LOCK_CHAN            2
+
+#ifndef _NO_LL_HANDLE
+typedef void LL_HANDLE;
+#endif
+
+#endif /* _LL_DEFS_H */
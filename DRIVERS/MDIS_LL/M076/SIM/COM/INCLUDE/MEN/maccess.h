@@ -0,0 +1,27 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: maccess.h
+ *
+ *  Description: Host simulation: hardware access macros
+ *               All accesses are passed to the M76 register model
+ *               (m76_sim.c). MACCESS points into the simulated
+ *               address space of the module.
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _MACCESS_H
+#define _MACCESS_H
+
+typedef volatile u_int8 *MACCESS;
+
+extern u_int16 M76SIM_Read16(MACCESS ma, u_int32 offs);
+extern void    M76SIM_Write16(MACCESS ma, u_int32 offs, u_int16 val);
+
+#define MREAD_D16(ma,offs)          M76SIM_Read16((ma),(offs))
+#define MWRITE_D16(ma,offs,val)     M76SIM_Write16((ma),(offs),(u_int16)(val))
+
+#define MACCESS_CLONE(ma_src,ma_dst,offs)   (ma_dst)=(MACCESS)((ma_src)+(offs))
+
+#endif /* _MACCESS_H */
@@ -0,0 +1,62 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: mdis_api.h
+ *
+ *  Description: Host simulation: MDIS user API (see sim_mdis.c)
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _MDIS_API_H
+#define _MDIS_API_H
+
+typedef INT32_OR_64 MDIS_PATH;
+
+typedef struct {
+    int32       size;       /* size of data buffer */
+    void        *data;      /* data buffer */
+} M_SG_BLOCK;
+
+/* status code offsets */
+#define M_LL_OF             0x0000
+#define M_DEV_OF            0x0100
+#define M_MK_OF             0x0200
+#define M_LL_BLK_OF         0x1000
+#define M_DEV_BLK_OF        0x1100
+#define M_MK_BLK_OF         0x1200
+
+/* low-level status codes */
+#define M_LL_DEBUG_LEVEL    (M_LL_OF+0x00)
+#define M_LL_CH_NUMBER      (M_LL_OF+0x01)
+#define M_LL_CH_DIR         (M_LL_OF+0x02)
+#define M_LL_CH_LEN         (M_LL_OF+0x03)
+#define M_LL_CH_TYP         (M_LL_OF+0x04)
+#define M_LL_IRQ_COUNT      (M_LL_OF+0x05)
+#define M_LL_ID_CHECK       (M_LL_OF+0x06)
+#define M_LL_ID_SIZE        (M_LL_OF+0x07)
+#define M_LL_BLK_ID_DATA    (M_LL_BLK_OF+0x01)
+#define M_MK_BLK_REV_ID     (M_MK_BLK_OF+0x01)
+
+/* MDIS kernel status codes */
+#define M_MK_CH_CURRENT     (M_MK_OF+0x03)
+#define M_MK_IRQ_ENABLE     (M_MK_OF+0x0c)
+
+/* channel types/directions */
+#define M_CH_IN             0
+#define M_CH_OUT            1
+#define M_CH_INOUT          2
+#define M_CH_UNKNOWN        0
+#define M_CH_ANALOG         1
+
+extern MDIS_PATH M_open(const char *device);
+extern int32 M_close(MDIS_PATH path);
+extern int32 M_read(MDIS_PATH path, int32 *valueP);
+extern int32 M_write(MDIS_PATH path, int32 value);
+extern int32 M_getblock(MDIS_PATH path, u_int8 *buffer, int32 length);
+extern int32 M_setblock(MDIS_PATH path, const u_int8 *buffer, int32 length);
+extern int32 M_setstat(MDIS_PATH path, int32 code, INT32_OR_64 data);
+extern int32 M_getstat(MDIS_PATH path, int32 code, int32 *dataP);
+extern char  *M_errstring(int32 errCode);
+
+#endif /* _MDIS_API_H */
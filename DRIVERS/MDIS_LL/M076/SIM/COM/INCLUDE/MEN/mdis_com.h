@@ -0,0 +1,31 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: mdis_com.h
+ *
+ *  Description: Host simulation: MDIS common definitions
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _MDIS_COM_H
+#define _MDIS_COM_H
+
+/* address/data modes */
+#define MDIS_MA08           0x01
+#define MDIS_MD08           0x01
+#define MDIS_MD16           0x02
+
+/* address space types */
+#define MDIS_MA_BB_INFO_PTR 0x00
+
+/* ident function table */
+#define MDIS_MAX_IDENT_CALLS 16
+
+typedef struct {
+    struct {
+        char *(*identCall)(void);
+    } idCall[MDIS_MAX_IDENT_CALLS];
+} MDIS_IDENT_FUNCT_TBL;
+
+#endif /* _MDIS_COM_H */
@@ -0,0 +1,52 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: mdis_err.h
+ *
+ *  Description: Host simulation: MDIS error codes (subset)
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _MDIS_ERR_H
+#define _MDIS_ERR_H
+
+#define ERR_SUCCESS         0
+
+#define ERR_OS              0x0001
+#define ERR_OSS             0x0500
+#define ERR_OSS_MEM_ALLOC   (ERR_OSS+0x01)
+#define ERR_OSS_ILL_PARAM   (ERR_OSS+0x02)
+#define ERR_OSS_TIMEOUT     (ERR_OSS+0x0a)
+#define ERR_OSS_SIG_SET     (ERR_OSS+0x10)
+#define ERR_OSS_SIG_CLR     (ERR_OSS+0x11)
+#define ERR_OSS_ALARM_CLR   (ERR_OSS+0x12)
+#define ERR_OSS_ALARM_SET   (ERR_OSS+0x13)
+
+#define ERR_DESC            0x0600
+#define ERR_DESC_KEY_NOTFOUND (ERR_DESC+0x01)
+#define ERR_DESC_BUF_TOOSMALL (ERR_DESC+0x04)
+
+#define ERR_ID              0x0700
+
+#define ERR_MK              0x0800
+#define ERR_MK_ILL_PARAM    (ERR_MK+0x01)
+#define ERR_MK_NO_LLDRV     (ERR_MK+0x02)
+#define ERR_MK_UNK_CODE     (ERR_MK+0x05)
+
+#define ERR_LL              0x0900
+#define ERR_LL_ILL_PARAM    (ERR_LL+0x01)
+#define ERR_LL_ILL_ID       (ERR_LL+0x02)
+#define ERR_LL_ILL_DIR      (ERR_LL+0x03)
+#define ERR_LL_ILL_FUNC     (ERR_LL+0x04)
+#define ERR_LL_UNK_CODE     (ERR_LL+0x05)
+#define ERR_LL_USERBUF      (ERR_LL+0x06)
+#define ERR_LL_DEV_NOTRDY   (ERR_LL+0x07)
+#define ERR_LL_DEV_BUSY     (ERR_LL+0x08)
+#define ERR_LL_READ         (ERR_LL+0x09)
+#define ERR_LL_WRITE        (ERR_LL+0x0a)
+#define ERR_LL_ILL_CHAN     (ERR_LL+0x0b)
+
+#define ERR_DEV             0x0e00
+
+#endif /* _MDIS_ERR_H */
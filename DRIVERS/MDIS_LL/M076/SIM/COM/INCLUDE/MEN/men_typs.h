@@ -0,0 +1,37 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: men_typs.h
+ *
+ *  Description: Host simulation: MEN basic types (subset of MDIS men_typs.h)
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _MEN_TYPS_H
+#define _MEN_TYPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int8_t          int8;
+typedef uint8_t         u_int8;
+typedef int16_t         int16;
+typedef uint16_t        u_int16;
+typedef int32_t         int32;
+typedef uint32_t        u_int32;
+typedef int64_t         int64;
+typedef uint64_t        u_int64;
+
+/* pointer sized integers for setstat/getstat values */
+#define INT32_OR_64     intptr_t
+#define U_INT32_OR_64   uintptr_t
+
+#ifndef TRUE
+# define TRUE   1
+#endif
+#ifndef FALSE
+# define FALSE  0
+#endif
+
+#endif /* _MEN_TYPS_H */
@@ -0,0 +1,54 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: microwire.h
+ *
+ *  Description: Host simulation: microwire port library (subset)
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _MICROWIRE_H
+#define _MICROWIRE_H
+
+#define MCRW_DESC_PORT_FLAG_SIZE_8          0x01
+#define MCRW_DESC_PORT_FLAG_SIZE_16         0x02
+#define MCRW_DESC_PORT_FLAG_SIZE_32         0x04
+#define MCRW_DESC_PORT_FLAG_READABLE_REG    0x10
+#define MCRW_DESC_PORT_FLAG_POLARITY_HIGH   0x20
+#define MCRW_DESC_PORT_FLAG_OUT_IN_ONE_REG  0x40
+
+typedef struct {
+    u_int32     busClock;       /* OSS_MikroDelay per half clock [us] */
+    u_int32     addrLength;     /* address bits of EEPROM */
+    u_int32     flagsDataIn;
+    u_int32     flagsDataOut;
+    u_int32     flagsClockOut;
+    u_int32     flagsCsOut;
+    u_int32     flagsOut;
+    void        *addrDataIn;
+    u_int32     maskDataIn;
+    void        *addrDataOut;
+    u_int32     maskDataOut;
+    u_int32     notReadBackDefaultsDataOut;
+    u_int32     notReadBackMaskDataOut;
+    void        *addrClockOut;
+    u_int32     maskClockOut;
+    u_int32     notReadBackDefaultsClockOut;
+    u_int32     notReadBackMaskClockOut;
+    void        *addrCsOut;
+    u_int32     maskCsOut;
+    u_int32     notReadBackDefaultsCsOut;
+    u_int32     notReadBackMaskCsOut;
+} MCRW_DESC_PORT;
+
+typedef struct MCRW_HANDLE {
+    int32 (*Exit)(void **hdlP);
+    int32 (*ReadEeprom)(void *hdl, u_int16 addr, u_int16 *buf, u_int16 size);
+    char  *(*Ident)(void);
+} MCRW_HANDLE;
+
+extern int32 MCRW_PORT_Init(MCRW_DESC_PORT *desc, OSS_HANDLE *osHdl,
+                            void **hdlP);
+
+#endif /* _MICROWIRE_H */
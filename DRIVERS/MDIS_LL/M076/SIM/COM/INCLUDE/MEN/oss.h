@@ -0,0 +1,59 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: oss.h
+ *
+ *  Description: Host simulation: operating system services
+ *               Time is virtual: OSS_Delay/OSS_MikroDelay/OSS_SemWait
+ *               advance the simulation clock (see sim_oss.c).
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _OSS_H
+#define _OSS_H
+
+typedef struct OSS_HANDLE       OSS_HANDLE;
+typedef struct OSS_IRQ_HANDLE   OSS_IRQ_HANDLE;
+typedef struct OSS_SEM_HANDLE   OSS_SEM_HANDLE;
+typedef struct OSS_SIG_HANDLE   OSS_SIG_HANDLE;
+typedef struct OSS_ALARM_HANDLE OSS_ALARM_HANDLE;
+typedef int32                   OSS_IRQ_STATE;
+
+#define OSS_DBG_DEFAULT         0xc0008000
+
+#define OSS_SEM_BIN             0
+#define OSS_SEM_COUNT           1
+#define OSS_SEM_WAITFOREVER     -1
+
+extern void  *OSS_MemGet(OSS_HANDLE *os, u_int32 size, u_int32 *gotsizeP);
+extern int32 OSS_MemFree(OSS_HANDLE *os, void *addr, u_int32 size);
+extern void  OSS_MemFill(OSS_HANDLE *os, u_int32 size, char *adr, int8 value);
+extern void  OSS_MemCopy(OSS_HANDLE *os, u_int32 size, char *src, char *dest);
+extern int32 OSS_Delay(OSS_HANDLE *os, int32 msec);
+extern int32 OSS_MikroDelay(OSS_HANDLE *os, u_int32 usec);
+extern int32 OSS_TickGet(OSS_HANDLE *os);
+extern int32 OSS_TickRateGet(OSS_HANDLE *os);
+extern int32 OSS_SemCreate(OSS_HANDLE *os, int32 semType, int32 initVal,
+                           OSS_SEM_HANDLE **semP);
+extern int32 OSS_SemRemove(OSS_HANDLE *os, OSS_SEM_HANDLE **semP);
+#define OSS_SEM_NOWAIT      0       /* OSS_SemWait: don't wait */
+
+extern int32 OSS_SemWait(OSS_HANDLE *os, OSS_SEM_HANDLE *sem, int32 msec);
+extern int32 OSS_SemSignal(OSS_HANDLE *os, OSS_SEM_HANDLE *sem);
+extern int32 OSS_SigCreate(OSS_HANDLE *os, int32 signal,
+                           OSS_SIG_HANDLE **sigP);
+extern int32 OSS_SigRemove(OSS_HANDLE *os, OSS_SIG_HANDLE **sigP);
+extern int32 OSS_SigSend(OSS_HANDLE *os, OSS_SIG_HANDLE *sig);
+extern int32 OSS_AlarmCreate(OSS_HANDLE *os, void (*funct)(void *arg),
+                             void *arg, OSS_ALARM_HANDLE **alarmP);
+extern int32 OSS_AlarmRemove(OSS_HANDLE *os, OSS_ALARM_HANDLE **alarmP);
+extern int32 OSS_AlarmSet(OSS_HANDLE *os, OSS_ALARM_HANDLE *alarm,
+                          u_int32 msec, u_int32 cyclic, u_int32 *realMsecP);
+extern int32 OSS_AlarmClear(OSS_HANDLE *os, OSS_ALARM_HANDLE *alarm);
+extern OSS_IRQ_STATE OSS_IrqMaskR(OSS_HANDLE *os, OSS_IRQ_HANDLE *irq);
+extern void  OSS_IrqRestore(OSS_HANDLE *os, OSS_IRQ_HANDLE *irq,
+                            OSS_IRQ_STATE state);
+extern char  *OSS_Ident(void);
+
+#endif /* _OSS_H */
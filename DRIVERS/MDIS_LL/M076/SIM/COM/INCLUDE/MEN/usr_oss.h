@@ -0,0 +1,21 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: usr_oss.h
+ *
+ *  Description: Host simulation: user mode OS services (subset)
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _USR_OSS_H
+#define _USR_OSS_H
+
+extern int32   UOS_ErrnoGet(void);
+extern int32   UOS_KeyWait(void);
+extern int32   UOS_KeyPressed(void);
+extern int32   UOS_Delay(u_int32 msec);
+extern u_int32 UOS_MsecTimerGet(void);
+extern u_int32 UOS_MsecTimerResolution(void);
+
+#endif /* _USR_OSS_H */
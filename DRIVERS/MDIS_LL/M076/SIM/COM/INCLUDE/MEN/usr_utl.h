@@ -0,0 +1,21 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: usr_utl.h
+ *
+ *  Description: Host simulation: user mode utilities (option parsing)
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany 
+ ****************************************************************************/
+
+#ifndef _USR_UTL_H
+#define _USR_UTL_H
+
+/* expect argc/argv of main() and char buf[] in scope */
+#define UTL_TSTOPT(opt)             UTL_Tstopt(argc, argv, opt, buf)
+#define UTL_ILLIOPT(opts,errstr)    UTL_Illiopt(argc, argv, opts, errstr)
+
+extern char *UTL_Tstopt(int argc, char **argv, char *option, char *buf);
+extern char *UTL_Illiopt(int argc, char **argv, char *opts, char *errstr);
+
+#endif /* _USR_UTL_H */
@@ -0,0 +1,1006 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************
+ *
+ *         Name: m76_sim.c
+ *      Project: M76 host simulation
+ *
+ *  Description: Register-level model of the M76 M-Module
+ *
+ *               Module registers:
+ *                 0x00/0x02  DATA    24-bit transfer latch (hi/lo word)
+ *                 0x04/0x06  CONFIG  measurement range relays (hi/lo word)
+ *                 0x08       COM     byte to ADC serial interface
+ *                 0x0a       ACCESS  TR24R/IRQ, write clears TRDYR/IRQ_PEND
+ *                 0x0c       STAT    TRDYR/IRQ_PEND
+ *                 0x0e       CTRL    ADC reset, ID PROM/user EEPROM select
+ *                 0xfe       PLD_IF  microwire lines DAT/CLK/CS
+ *
+ *               ADC (AD7714 type, fclk=2.4576MHz):
+ *               - communication, mode, filter high/low, data and per
+ *                 channel zero-/full-scale calibration registers
+ *               - output period = filter word * 128 / fclk, first valid
+ *                 data 3 periods after mode/filter/channel/range change
+ *                 (sinc^3 settling), calibration takes 4 periods
+ *               - zero-scale self-calibration measures the offset of the
+ *                 ADC only (drift, M76SIM_DriftSet), system calibration
+ *                 that of the whole input path
+ *               - DRDY is set by each conversion and cleared by reading
+ *                 the data register
+ *
+ *               A TR24R transfer waits for DRDY, moves the register
+ *               selected by the last communication byte to the DATA
+ *               latch and sets TRDYR (and IRQ_PEND if IRQ is set).
+ *               Conversion results are latched left-aligned (bits 31..8),
+ *               all other registers right-aligned.
+ *
+ *               Analog inputs are fractions of full scale per ADC channel.
+ *               Every range/channel gets a fixed offset and gain error,
+ *               so calibration values differ per range like on hardware.
+ *
+ *               EEPROMs (93Cxx microwire, on PLD_IF):
+ *               - ID PROM 93C46 (6 address bits), CTRL bit 2 clear
+ *               - user EEPROM 93C66 (8 address bits), CTRL bit 2 set
+ *               - READ (sequential), WRITE, ERASE, EWEN/EWDS, ERAL/WRAL
+ *               - self-timed programming, DO shows busy/ready
+ *
+ *     Required: sim_oss.c (virtual clock)
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+ ****************************************************************************/
+
+#include <string.h>
+#include <MEN/men_typs.h>
+#include <MEN/maccess.h>
+#include <MEN/oss.h>
+#include <MEN/desc.h>
+#include "m76_sim.h"
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+/* module register offsets */
+#define DATA_REG            0x00
+#define CONFIG_REG          0x04
+#define COM_REG             0x08
+#define ACCESS_REG          0x0a
+#define STAT_REG            0x0c
+#define CTRL_REG            0x0e
+#define PLD_IF_REG          0xfe
+
+/* access/status register */
+#define IRQ                 0x8
+#define TR24R               0x4
+#define IRQ_PEND            0x8
+#define TRDYR               0x4
+
+/* control register */
+#define CTRL_NRESET         0x2         /* ADC out of reset */
+#define CTRL_UEE            0x4         /* user EEPROM selected */
+
+/* PLD_IF_REG */
+#define B_DAT               0x01
+#define B_CLK               0x02
+#define B_SEL               0x04
+
+/* ADC communication register */
+#define RS_COM              0
+#define RS_MODE             1
+#define RS_FHI              2
+#define RS_FLO              3
+#define RS_TEST             4
+#define RS_DATA             5
+#define RS_ZERO             6
+#define RS_FULL             7
+#define COM_READ            0x08
+
+/* ADC mode register */
+#define MD_NORMAL           0
+#define MD_ZERO             2
+#define MD_FULL             3
+#define MD_ZERO_SELF        6
+
+/* ADC filter high register */
+#define FHI_UNI             0x80
+#define FHI_WL              0x40        /* 24-bit data word (else 16-bit) */
+
+/* timing [ns] */
+#define FCLK_HZ             2457600
+#define XFER_NS             20000       /* 24-bit serial transfer */
+#define BUS_NS              300         /* default register access */
+#define EE_PROG_NS          3000000     /* EEPROM self-timed programming */
+
+#define FULL24              0x1000000   /* 2^24 */
+#define NO_TIME             ((u_int64)-1)
+
+/* EEPROM states */
+#define EE_IDLE             0           /* wait for start bit */
+#define EE_CMD              1           /* shift opcode/address */
+#define EE_READ             2           /* shift out data */
+#define EE_WDATA            3           /* shift in data */
+#define EE_DONE             4           /* wait for CS low */
+
+/* EEPROM opcodes */
+#define EE_OP_EXT           0
+#define EE_OP_WRITE         1
+#define EE_OP_READ          2
+#define EE_OP_ERASE         3
+
+/* factory calibration in user EEPROM */
+#define UEE_CALI_WORDS      0x90        /* calibration values */
+#define UEE_MAGIC           0x3730      /* magic word after checksum */
+#define ADC_R_I             2           /* resistance: measurement current */
+#define ADC_R_U             3           /* resistance: voltage of resistor */
+#define ADC_DC              4
+#define ADC_AC              6
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+typedef struct {
+    u_int16     mem[M76SIM_UEE_WORDS];
+    u_int32     words;          /* size in words */
+    u_int32     addrBits;       /* address bits */
+    int32       cs, clk;        /* line states */
+    int32       state;          /* EE_xxx */
+    u_int32     sr, nBits;      /* shift register */
+    u_int32     op, addr;       /* decoded command */
+    u_int32     ewen;           /* erase/write enabled */
+    u_int32     prog;           /* programming requested (CS low starts) */
+    u_int16     wData;          /* data to write */
+    u_int32     rdBit;          /* next data bit to shift out */
+    int32       dout;           /* DO line */
+    u_int64     tReady;         /* programming done */
+    u_int32     *rdCnt;         /* read counter */
+} SIM_EE;
+
+typedef struct {
+    u_int8      space[M76SIM_SPACE_SIZE];   /* MACCESS points here */
+    u_int32     busNs;          /* time per register access */
+    /* module registers */
+    u_int32     config;
+    u_int16     cfgH;
+    u_int16     access;
+    u_int16     stat;
+    u_int16     ctrl;
+    u_int16     dataH, dataL;   /* read latch */
+    u_int16     wrH;            /* write latch high word */
+    /* ADC */
+    u_int8      comm;           /* last communication byte */
+    int32       expect;         /* register the next byte is written to */
+    u_int8      mode, filHi, filLo;
+    u_int32     calZero[8];
+    u_int32     calFull[8];
+    u_int32     dataReg;
+    int32       drdy;
+    u_int64     tConv;          /* next conversion done */
+    int32       xferPend;       /* TR24R armed */
+    u_int64     tXfer;          /* transfer done (NO_TIME: wait for DRDY) */
+    /* analog */
+    double      input[8];       /* fraction of full scale per channel */
+    u_int32     noise;          /* noise amplitude [counts] */
+    int32       drift;          /* ADC offset drift [counts] */
+    u_int32     seed;
+    /* EEPROMs */
+    SIM_EE      idp;
+    SIM_EE      uee;
+    M76SIM_STAT st;
+} SIM_MOD;
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+static SIM_MOD G_mod;
+
+/* configuration of ranges in user EEPROM order (DC V, AC V, DC A, AC A, R) */
+static const u_int32 G_caliCfg[] = {
+    0x06fae600, 0x06fae500, 0x02fae600, 0x02fae500, 0x02fae500,
+    0x04fbf500, 0x04fbe600, 0x04fbd600, 0x00fbb600,
+    0x287de500, 0x28bde500, 0x30dde500, 0x30ede500,
+    0x0877e500, 0x08b7e500, 0x10d7e500,
+    0x4bf9bd00, 0x4bf9bd00, 0x4bf9dd00, 0x4bf9ed00, 0x4bf9f500,
+    0x43f9bd00, 0x43f9bd00, 0x43f9dd00, 0x43f9ed00, 0x43f9f500
+};
+#define CALI_VA_NUM         16          /* voltage/current ranges */
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+static void    Update(u_int64 now);
+static u_int64 ConvPeriod(void);
+static void    Restart(u_int64 now);
+static void    Convert(u_int64 t);
+static void    XferDone(void);
+static int32   Raw(u_int32 chan, double x);
+static int32   RawIdeal(u_int32 config, u_int32 chan, double x);
+static void    UeeFactory(SIM_EE *ee);
+static void    AdcByte(u_int8 b, u_int64 now);
+static void    AdcWrite24(u_int32 val);
+static void    EeInit(SIM_EE *ee, u_int32 words, u_int32 addrBits, u_int32 *rdCnt);
+static void    EeLines(SIM_EE *ee, u_int16 val, u_int64 now);
+static int32   EeDout(SIM_EE *ee, u_int64 now);
+
+/******************************** M76SIM_Init *******************************
+ *
+ *  Description: Reset the module model (power on).
+ *               The user EEPROM content is kept, at the first call it
+ *               gets a factory calibration of all ranges.
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     hardware access handle of module
+ *  Globals....: G_mod
+ ****************************************************************************/
+MACCESS M76SIM_Init(void)
+{
+    SIM_MOD *m = &G_mod;
+    u_int16 uee[M76SIM_UEE_WORDS];
+    int32 i, keep = (m->uee.words != 0);
+
+    if (keep)
+        memcpy(uee, m->uee.mem, sizeof(uee));
+
+    memset(m, 0, sizeof(*m));
+    m->busNs  = BUS_NS;
+    m->expect = -1;
+    m->filHi  = 0x01;           /* power-on filter word 0x180 */
+    m->filLo  = 0x80;
+    m->noise  = 8;
+    m->seed   = 0x4d3736;
+    m->tConv  = NO_TIME;        /* held in reset */
+    for (i=0; i<8; i++)  {
+        m->calZero[i] = 0;
+        m->calFull[i] = FULL24 / 4;
+        m->input[i]   = 0.5;
+    }
+    m->input[2] = 0.6;          /* COM_R_I: measurement current */
+    m->input[3] = 0.3;          /* COM_R_U: voltage of resistor */
+
+    EeInit(&m->idp, M76SIM_IDP_WORDS, 6, &m->st.idpRead);
+    EeInit(&m->uee, M76SIM_UEE_WORDS, 8, &m->st.ueeRead);
+
+    /* ID PROM: magic, module ID, revision, variant, serial number */
+    m->idp.mem[0] = 0x5346;
+    m->idp.mem[1] = 76;
+    m->idp.mem[2] = 1;
+    m->idp.mem[3] = 0;
+    m->idp.mem[4] = 0;
+    m->idp.mem[5] = 1;
+
+    if (keep)
+        memcpy(m->uee.mem, uee, sizeof(uee));
+    else
+        UeeFactory(&m->uee);
+
+    return(m->space);
+}
+
+/******************************** M76SIM_Read16 *****************************
+ *
+ *  Description: Read module register (MREAD_D16).
+ *---------------------------------------------------------------------------
+ *  Input......: ma         hardware access handle
+ *               offs       register offset
+ *  Output.....: return     register value
+ *  Globals....: G_mod
+ ****************************************************************************/
+u_int16 M76SIM_Read16(MACCESS ma, u_int32 offs)
+{
+    SIM_MOD *m = &G_mod;
+    u_int64 now;
+    u_int16 val = 0xffff;
+
+    SIM_TimeSpend(m->busNs);
+    now = SIM_TimeNs();
+    Update(now);
+    m->st.rd16++;
+
+    offs += (u_int32)(ma - m->space);
+    switch (offs)  {
+    case DATA_REG:      val = m->dataH;                 break;
+    case DATA_REG+2:    val = m->dataL;                 break;
+    case CONFIG_REG:    val = (u_int16)(m->config >> 16);   break;
+    case CONFIG_REG+2:  val = (u_int16)m->config;       break;
+    case ACCESS_REG:    val = m->access;                break;
+    case STAT_REG:      val = m->stat;                  break;
+    case CTRL_REG:      val = m->ctrl;                  break;
+    case PLD_IF_REG:
+        val = (u_int16)( 0xfff8 | (EeDout((m->ctrl & CTRL_UEE) ?
+                                          &m->uee : &m->idp, now) ? B_DAT : 0) );
+        break;
+    }
+    return(val);
+}
+
+/******************************** M76SIM_Write16 ****************************
+ *
+ *  Description: Write module register (MWRITE_D16).
+ *---------------------------------------------------------------------------
+ *  Input......: ma         hardware access handle
+ *               offs       register offset
+ *               val        value to write
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+void M76SIM_Write16(MACCESS ma, u_int32 offs, u_int16 val)
+{
+    SIM_MOD *m = &G_mod;
+    u_int64 now;
+
+    SIM_TimeSpend(m->busNs);
+    now = SIM_TimeNs();
+    Update(now);
+    m->st.wr16++;
+
+    offs += (u_int32)(ma - m->space);
+    switch (offs)  {
+    case DATA_REG:
+        m->wrH = val;
+        break;
+    case DATA_REG+2:
+        AdcWrite24(((u_int32)(m->wrH & 0xff) << 16) | val);
+        break;
+    case CONFIG_REG:
+        m->cfgH = val;
+        break;
+    case CONFIG_REG+2:
+        m->config = ((u_int32)m->cfgH << 16) | val;
+        Restart(now);           /* relays switched, input settles */
+        break;
+    case COM_REG:
+        if (m->ctrl & CTRL_NRESET)
+            AdcByte((u_int8)val, now);
+        break;
+    case ACCESS_REG:
+        m->access = val & (IRQ|TR24R);
+        m->stat  &= ~(TRDYR|IRQ_PEND);
+        m->xferPend = (val & TR24R) ? TRUE : FALSE;
+        m->tXfer = NO_TIME;
+        /* register other than data register or data ready: start now */
+        if (m->xferPend && (((m->comm >> 4) & 7) != RS_DATA || m->drdy))
+            m->tXfer = now + XFER_NS;
+        break;
+    case CTRL_REG:
+        if ((val & CTRL_NRESET) && !(m->ctrl & CTRL_NRESET))  {
+            m->ctrl = val;
+            Restart(now);       /* leave reset */
+        }
+        else if (!(val & CTRL_NRESET))  {
+            m->tConv = NO_TIME; /* hold ADC in reset */
+            m->drdy = FALSE;
+        }
+        m->ctrl = val;
+        break;
+    case PLD_IF_REG:
+        EeLines((m->ctrl & CTRL_UEE) ? &m->uee : &m->idp, val, now);
+        break;
+    }
+}
+
+/******************************** M76SIM_NextEvent **************************
+ *
+ *  Description: Get time of next event which changes the interrupt line.
+ *---------------------------------------------------------------------------
+ *  Input......: nowNs      current time
+ *  Output.....: *tP        time of event
+ *               return     TRUE if event pending
+ *  Globals....: G_mod
+ ****************************************************************************/
+int32 M76SIM_NextEvent(u_int64 nowNs, u_int64 *tP)
+{
+    SIM_MOD *m = &G_mod;
+
+    Update(nowNs);
+
+    if (!m->xferPend || !(m->access & IRQ))
+        return(FALSE);
+
+    if (m->tXfer != NO_TIME)
+        *tP = m->tXfer;
+    else if (m->tConv != NO_TIME)
+        *tP = m->tConv + XFER_NS;
+    else
+        return(FALSE);
+
+    return(TRUE);
+}
+
+/******************************** M76SIM_IrqLine ****************************
+ *
+ *  Description: Get state of interrupt line.
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     TRUE if interrupt pending
+ *  Globals....: G_mod
+ ****************************************************************************/
+int32 M76SIM_IrqLine(void)
+{
+    return( (G_mod.stat & IRQ_PEND) ? TRUE : FALSE );
+}
+
+/******************************** M76SIM_InputSet ***************************
+ *
+ *  Description: Set analog input of ADC channel.
+ *---------------------------------------------------------------------------
+ *  Input......: chan       ADC channel (COM_xxx) or M76SIM_CHAN_ALL
+ *               frac       input as fraction of full scale
+ *                          (unipolar 0..1, bipolar -1..1)
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+void M76SIM_InputSet(int32 chan, double frac)
+{
+    int32 i;
+
+    for (i=0; i<8; i++)
+        if ((chan == M76SIM_CHAN_ALL) || (chan == i))
+            G_mod.input[i] = frac;
+}
+
+/******************************** M76SIM_NoiseSet ***************************
+ *
+ *  Description: Set peak noise of conversions.
+ *---------------------------------------------------------------------------
+ *  Input......: counts     peak noise [24-bit counts]
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+void M76SIM_NoiseSet(u_int32 counts)
+{
+    G_mod.noise = counts;
+}
+
+/******************************** M76SIM_DriftSet ***************************
+ *
+ *  Description: Set offset drift of the ADC (all channels and ranges).
+ *---------------------------------------------------------------------------
+ *  Input......: counts     offset [24-bit counts]
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+void M76SIM_DriftSet(int32 counts)
+{
+    G_mod.drift = counts;
+}
+
+/******************************** M76SIM_BusTimeSet *************************
+ *
+ *  Description: Set time of one register access.
+ *---------------------------------------------------------------------------
+ *  Input......: ns         access time [ns]
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+void M76SIM_BusTimeSet(u_int32 ns)
+{
+    G_mod.busNs = ns;
+}
+
+/******************************** M76SIM_UeeGet *****************************
+ *
+ *  Description: Get content of user EEPROM.
+ *---------------------------------------------------------------------------
+ *  Input......: words      number of words to get
+ *  Output.....: buf        EEPROM content
+ *  Globals....: G_mod
+ ****************************************************************************/
+void M76SIM_UeeGet(u_int16 *buf, u_int32 words)
+{
+    if (words > M76SIM_UEE_WORDS)
+        words = M76SIM_UEE_WORDS;
+    memcpy(buf, G_mod.uee.mem, words * 2);
+}
+
+/******************************** M76SIM_UeeSet *****************************
+ *
+ *  Description: Set content of user EEPROM, e.g. with a stored image.
+ *               Must be called after M76SIM_Init().
+ *---------------------------------------------------------------------------
+ *  Input......: buf        EEPROM content
+ *               words      number of words to set
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+void M76SIM_UeeSet(const u_int16 *buf, u_int32 words)
+{
+    if (words > M76SIM_UEE_WORDS)
+        words = M76SIM_UEE_WORDS;
+    memcpy(G_mod.uee.mem, buf, words * 2);
+}
+
+/******************************** M76SIM_StatGet ****************************
+ *
+ *  Description: Get access and event counters.
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: stat       counters
+ *  Globals....: G_mod
+ ****************************************************************************/
+void M76SIM_StatGet(M76SIM_STAT *stat)
+{
+    Update(SIM_TimeNs());
+    *stat = G_mod.st;
+}
+
+/*---------------------------------------------------------------------------
+ * ADC
+ *--------------------------------------------------------------------------*/
+
+/******************************** Update ************************************
+ *
+ *  Description: Process conversions and transfers up to now.
+ *---------------------------------------------------------------------------
+ *  Input......: now        current time
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+static void Update(u_int64 now)
+{
+    SIM_MOD *m = &G_mod;
+    u_int64 period = ConvPeriod();
+
+    for (;;)  {
+        if (m->xferPend && (m->tXfer != NO_TIME) && (m->tXfer <= now) &&
+            ((m->tConv == NO_TIME) || (m->tXfer <= m->tConv)))  {
+            XferDone();
+            continue;
+        }
+        if ((m->tConv == NO_TIME) || (m->tConv > now))
+            break;
+
+        /* nobody waits: skip conversions nobody can see */
+        if (!m->xferPend && (m->mode >> 5) == MD_NORMAL &&
+            (now - m->tConv) > period)
+            m->tConv += ((now - m->tConv) / period) * period;
+
+        Convert(m->tConv);
+    }
+}
+
+/******************************** ConvPeriod ********************************
+ *
+ *  Description: Get ADC output period derived from filter word.
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     period [ns]
+ *  Globals....: G_mod
+ ****************************************************************************/
+static u_int64 ConvPeriod(void)
+{
+    u_int64 fs = ((u_int32)(G_mod.filHi & 0xf) << 8) | G_mod.filLo;
+
+    if (fs < 19)                /* AD7714 filter word range 19..4000 */
+        fs = 19;
+
+    return( fs * 128 * 1000000000ULL / FCLK_HZ );
+}
+
+/******************************** Restart ***********************************
+ *
+ *  Description: Restart digital filter (mode/filter/channel/range change).
+ *---------------------------------------------------------------------------
+ *  Input......: now        current time
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+static void Restart(u_int64 now)
+{
+    SIM_MOD *m = &G_mod;
+    u_int32 md = m->mode >> 5;
+
+    if (!(m->ctrl & CTRL_NRESET))
+        return;
+
+    m->drdy  = FALSE;
+    m->tConv = now + ConvPeriod() *
+               (((md == MD_ZERO) || (md == MD_FULL) || (md == MD_ZERO_SELF)) ?
+                4 : 3);
+}
+
+/******************************** Convert ***********************************
+ *
+ *  Description: Complete conversion or calibration at time t.
+ *---------------------------------------------------------------------------
+ *  Input......: t          time of conversion
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+static void Convert(u_int64 t)
+{
+    SIM_MOD *m = &G_mod;
+    u_int32 ch = m->comm & 7;
+    u_int32 md = m->mode >> 5;
+    int32 zero, code;
+    int64 span;
+
+    if (md == MD_ZERO)  {
+        m->calZero[ch] = (u_int32)Raw(ch, 0.0) & 0xffffff;
+        m->mode &= 0x1f;        /* back to normal mode */
+        m->st.cali++;
+    }
+    else if (md == MD_ZERO_SELF)  {   /* inputs shorted internally */
+        m->calZero[ch] = (u_int32)(Raw(ch, 0.0) -
+                                   RawIdeal(m->config, ch, 0.0)) & 0xffffff;
+        m->mode &= 0x1f;
+        m->st.cali++;
+    }
+    else if (md == MD_FULL)  {
+        zero = ((int32)(m->calZero[ch] << 8)) >> 8;
+        m->calFull[ch] = (u_int32)((Raw(ch, 1.0) - zero) / 4) & 0xffffff;
+        m->mode &= 0x1f;
+        m->st.cali++;
+    }
+
+    zero = ((int32)(m->calZero[ch] << 8)) >> 8;
+    span = (int64)m->calFull[ch] * 4;
+    if (span == 0)
+        span = FULL24;
+
+    if (m->filHi & FHI_UNI)
+        code = (int32)(((int64)Raw(ch, m->input[ch]) - zero) * FULL24 / span);
+    else
+        code = (int32)(FULL24/2 +
+                       ((int64)Raw(ch, m->input[ch]) - zero) * (FULL24/2) / span);
+
+    if (code < 0)
+        code = 0;
+    if (code > FULL24-1)
+        code = FULL24-1;
+
+    m->dataReg = (u_int32)code;
+    m->drdy    = TRUE;
+    m->tConv   = t + ConvPeriod();
+    m->st.conv++;
+
+    /* transfer waiting for DRDY */
+    if (m->xferPend && (m->tXfer == NO_TIME))
+        m->tXfer = t + XFER_NS;
+}
+
+/******************************** XferDone **********************************
+ *
+ *  Description: Complete 24-bit transfer into DATA latch.
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+static void XferDone(void)
+{
+    SIM_MOD *m = &G_mod;
+    u_int32 ch = m->comm & 7, val;
+
+    switch ((m->comm >> 4) & 7)  {
+    case RS_DATA:
+        if (m->filHi & FHI_WL)
+            val = m->dataReg << 8;
+        else    /* 16-bit word, DOUT high for the remaining clocks */
+            val = ((m->dataReg >> 8) << 16) | 0xff00;
+        m->drdy = FALSE;
+        break;
+    case RS_ZERO:   val = m->calZero[ch];                       break;
+    case RS_FULL:   val = m->calFull[ch];                       break;
+    case RS_MODE:   val = m->mode;                              break;
+    case RS_FHI:    val = m->filHi;                             break;
+    case RS_FLO:    val = m->filLo;                             break;
+    default:        val = m->comm;                              break;
+    }
+    m->dataH = (u_int16)(val >> 16);
+    m->dataL = (u_int16)val;
+
+    m->xferPend = FALSE;
+    m->stat |= TRDYR;
+    m->st.xfer++;
+    if (m->access & IRQ)  {
+        m->stat |= IRQ_PEND;
+        m->st.irq++;
+    }
+}
+
+/******************************** Raw ***************************************
+ *
+ *  Description: Get modulator result of channel incl. range/channel
+ *               specific offset and gain error and noise.
+ *---------------------------------------------------------------------------
+ *  Input......: chan       ADC channel
+ *               x          input as fraction of full scale
+ *  Output.....: return     uncalibrated 24-bit result (signed)
+ *  Globals....: G_mod
+ ****************************************************************************/
+static int32 Raw(u_int32 chan, double x)
+{
+    SIM_MOD *m = &G_mod;
+    int32 n = 0;
+
+    if (m->noise)  {
+        m->seed = m->seed * 1103515245u + 12345u;
+        n = (int32)((m->seed >> 8) % (2 * m->noise + 1)) - (int32)m->noise;
+    }
+    return( RawIdeal(m->config, chan, x) + m->drift + n );
+}
+
+/******************************** RawIdeal **********************************
+ *
+ *  Description: Get noise-free modulator result of channel for range
+ *               configuration incl. offset and gain error.
+ *---------------------------------------------------------------------------
+ *  Input......: config     CONFIG register value
+ *               chan       ADC channel
+ *               x          input as fraction of full scale
+ *  Output.....: return     uncalibrated 24-bit result (signed)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 RawIdeal(u_int32 config, u_int32 chan, double x)
+{
+    u_int32 h = (config * 2654435761u) ^ ((chan + 1) * 40503u);
+    double gain = 1.0 + ((int32)(h % 2001) - 1000) / 50000.0;
+    int32 offs = (int32)((h >> 11) % 40001) - 20000;
+
+    return( (int32)(x * FULL24 * gain) + offs );
+}
+
+/******************************** AdcByte ***********************************
+ *
+ *  Description: Byte written to ADC serial interface (COM_REG).
+ *---------------------------------------------------------------------------
+ *  Input......: b          byte
+ *               now        current time
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+static void AdcByte(u_int8 b, u_int64 now)
+{
+    SIM_MOD *m = &G_mod;
+    u_int32 rs;
+
+    if (m->expect < 0)  {       /* communication register */
+        if ((b & 7) != (m->comm & 7))  {
+            m->comm = b;
+            Restart(now);       /* channel changed */
+        }
+        m->comm = b;
+        rs = (b >> 4) & 7;
+        if (!(b & COM_READ) && (rs == RS_MODE || rs == RS_FHI || rs == RS_FLO))
+            m->expect = rs;     /* 8-bit register data follows */
+        return;
+    }
+
+    switch (m->expect)  {
+    case RS_MODE:   m->mode  = b;   break;
+    case RS_FHI:    m->filHi = b;   break;
+    case RS_FLO:    m->filLo = b;   break;
+    }
+    m->expect = -1;
+    Restart(now);
+}
+
+/******************************** AdcWrite24 ********************************
+ *
+ *  Description: 24-bit register write via DATA_REG.
+ *---------------------------------------------------------------------------
+ *  Input......: val        value
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+static void AdcWrite24(u_int32 val)
+{
+    SIM_MOD *m = &G_mod;
+    u_int32 ch = m->comm & 7;
+
+    if (m->comm & COM_READ)
+        return;
+
+    switch ((m->comm >> 4) & 7)  {
+    case RS_ZERO:   m->calZero[ch] = val & 0xffffff;    break;
+    case RS_FULL:   m->calFull[ch] = val & 0xffffff;    break;
+    }
+}
+
+/******************************** UeeFactory ********************************
+ *
+ *  Description: Write factory calibration of all ranges to user EEPROM.
+ *               Values are those a system calibration of the range
+ *               would return (zero-scale = offset, full-scale = span/4),
+ *               stored low word first, followed by XOR checksum and
+ *               magic word.
+ *               Resistance ranges: Im zero/full in rOpen.zero/rShort.full,
+ *               Ux zero/full in rShort.zero/rOpen.full.
+ *---------------------------------------------------------------------------
+ *  Input......: ee         user EEPROM
+ *  Output.....: -
+ *  Globals....: G_caliCfg
+ ****************************************************************************/
+static void UeeFactory(SIM_EE *ee)
+{
+    u_int32 vals[UEE_CALI_WORDS/2], *v = vals;
+    u_int32 i, cfg, ch;
+    int32 zero;
+    u_int16 checkSum = 0;
+
+    for (i=0; i < sizeof(G_caliCfg)/sizeof(G_caliCfg[0]); i++)  {
+        cfg = G_caliCfg[i];
+        if (i < CALI_VA_NUM)  {
+            /* DC V 0..4 and DC A 9..12 on DC channel, others on AC */
+            ch = (i < 5 || (i >= 9 && i < 13)) ? ADC_DC : ADC_AC;
+            zero = RawIdeal(cfg, ch, 0.0);
+            *v++ = (u_int32)zero & 0xffffff;
+            *v++ = (u_int32)((RawIdeal(cfg, ch, 1.0) - zero) / 4) & 0xffffff;
+        }
+        else  {
+            /* rShort.zero, rShort.full, rOpen.zero, rOpen.full */
+            *v++ = (u_int32)RawIdeal(cfg, ADC_R_U, 0.0) & 0xffffff;
+            *v++ = ((RawIdeal(cfg, ADC_R_I, 1.0) -
+                     RawIdeal(cfg, ADC_R_I, 0.0)) / 4) & 0xffffff;
+            *v++ = (u_int32)RawIdeal(cfg, ADC_R_I, 0.0) & 0xffffff;
+            *v++ = ((RawIdeal(cfg, ADC_R_U, 1.0) -
+                     RawIdeal(cfg, ADC_R_U, 0.0)) / 4) & 0xffffff;
+        }
+    }
+
+    for (i=0; i < UEE_CALI_WORDS/2; i++)  {
+        ee->mem[2*i]   = (u_int16)vals[i];
+        ee->mem[2*i+1] = (u_int16)(vals[i] >> 16);
+        checkSum ^= ee->mem[2*i] ^ ee->mem[2*i+1];
+    }
+    ee->mem[UEE_CALI_WORDS]   = checkSum;
+    ee->mem[UEE_CALI_WORDS+1] = UEE_MAGIC;
+}
+
+/*---------------------------------------------------------------------------
+ * 93Cxx EEPROM
+ *--------------------------------------------------------------------------*/
+
+/******************************** EeInit ************************************
+ *
+ *  Description: Init EEPROM model (blank).
+ *---------------------------------------------------------------------------
+ *  Input......: ee         EEPROM
+ *               words      size [words]
+ *               addrBits   address bits
+ *               rdCnt      read counter
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void EeInit(SIM_EE *ee, u_int32 words, u_int32 addrBits, u_int32 *rdCnt)
+{
+    memset(ee, 0, sizeof(*ee));
+    memset(ee->mem, 0xff, sizeof(ee->mem));
+    ee->words    = words;
+    ee->addrBits = addrBits;
+    ee->rdCnt    = rdCnt;
+    ee->dout     = 1;
+}
+
+/******************************** EeLines ***********************************
+ *
+ *  Description: New state of microwire lines.
+ *---------------------------------------------------------------------------
+ *  Input......: ee         EEPROM
+ *               val        PLD_IF_REG value (DAT/CLK/CS)
+ *               now        current time
+ *  Output.....: -
+ *  Globals....: G_mod
+ ****************************************************************************/
+static void EeLines(SIM_EE *ee, u_int16 val, u_int64 now)
+{
+    int32 cs  = (val & B_SEL) ? 1 : 0;
+    int32 clk = (val & B_CLK) ? 1 : 0;
+    int32 di  = (val & B_DAT) ? 1 : 0;
+    int32 rise = clk && !ee->clk && cs;
+    u_int32 i, mask = ee->words - 1;
+
+    /* CS falling edge: start self-timed programming */
+    if (!cs && ee->cs)  {
+        if (ee->prog && ee->ewen && (now >= ee->tReady))  {
+            if (ee->op == EE_OP_WRITE)
+                ee->mem[ee->addr & mask] = ee->wData;
+            else if (ee->op == EE_OP_ERASE)
+                ee->mem[ee->addr & mask] = 0xffff;
+            else if ((ee->addr >> (ee->addrBits-2)) == 2)   /* ERAL */
+                for (i=0; i<ee->words; i++)
+                    ee->mem[i] = 0xffff;
+            else                                            /* WRAL */
+                for (i=0; i<ee->words; i++)
+                    ee->mem[i] = ee->wData;
+            ee->tReady = now + EE_PROG_NS;
+            if (ee == &G_mod.uee)
+                G_mod.st.ueeProg++;
+        }
+        ee->prog  = FALSE;
+        ee->state = EE_IDLE;
+    }
+    /* CS rising edge: wait for start bit */
+    if (cs && !ee->cs)
+        ee->state = EE_IDLE;
+
+    ee->cs  = cs;
+    ee->clk = clk;
+
+    if (!rise || (now < ee->tReady))    /* busy: inputs ignored */
+        return;
+
+    switch (ee->state)  {
+    case EE_IDLE:
+        if (di)  {              /* start bit */
+            ee->state = EE_CMD;
+            ee->sr = 0;
+            ee->nBits = 0;
+        }
+        break;
+
+    case EE_CMD:
+        ee->sr = (ee->sr << 1) | di;
+        if (++ee->nBits < 2 + ee->addrBits)
+            break;
+
+        ee->op   = ee->sr >> ee->addrBits;
+        ee->addr = ee->sr & ((1 << ee->addrBits) - 1);
+        ee->state = EE_DONE;
+
+        switch (ee->op)  {
+        case EE_OP_READ:
+            ee->state = EE_READ;
+            ee->rdBit = 16;
+            ee->dout  = 0;      /* dummy bit */
+            (*ee->rdCnt)++;
+            break;
+        case EE_OP_WRITE:
+            ee->state = EE_WDATA;
+            ee->nBits = 0;
+            break;
+        case EE_OP_ERASE:
+            ee->prog = TRUE;
+            break;
+        case EE_OP_EXT:
+            switch (ee->addr >> (ee->addrBits-2))  {
+            case 0: ee->ewen = FALSE;   break;      /* EWDS */
+            case 1:                                 /* WRAL */
+                ee->state = EE_WDATA;
+                ee->nBits = 0;
+                break;
+            case 2: ee->prog = TRUE;    break;      /* ERAL */
+            case 3: ee->ewen = TRUE;    break;      /* EWEN */
+            }
+            break;
+        }
+        break;
+
+    case EE_READ:
+        if (ee->rdBit == 0)  {  /* sequential read */
+            ee->addr = (ee->addr + 1) & mask;
+            ee->rdBit = 16;
+            (*ee->rdCnt)++;
+        }
+        ee->rdBit--;
+        ee->dout = (ee->mem[ee->addr & mask] >> ee->rdBit) & 1;
+        break;
+
+    case EE_WDATA:
+        ee->wData = (u_int16)((ee->wData << 1) | di);
+        if (++ee->nBits == 16)  {
+            ee->prog  = TRUE;
+            ee->state = EE_DONE;
+        }
+        break;
+    }
+}
+
+/******************************** EeDout ************************************
+ *
+ *  Description: Get state of DO line.
+ *---------------------------------------------------------------------------
+ *  Input......: ee         EEPROM
+ *               now        current time
+ *  Output.....: return     DO line
+ *  Globals....: -
+ ****************************************************************************/
+static int32 EeDout(SIM_EE *ee, u_int64 now)
+{
+    if (!ee->cs)
+        return(1);
+
+    if (ee->state == EE_READ)
+        return(ee->dout);
+
+    /* ready/busy status */
+    return( (now >= ee->tReady) ? 1 : 0 );
+}
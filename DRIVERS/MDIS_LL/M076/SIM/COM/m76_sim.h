@@ -0,0 +1,80 @@
+/***********************  I n c l u d e  -  F i l e  ************************
+ *
+ *         Name: m76_sim.h
+ *
+ *  Description: Host simulation of the M76 M-Module
+ *               - register-level model of the module (m76_sim.c)
+ *               - virtual clock, interrupt and descriptor hooks of the
+ *                 simulated OSS/MDIS layers (sim_oss.c, sim_mdis.c)
+ *
+ *               All time is virtual: it only advances in OSS_Delay,
+ *               OSS_MikroDelay, OSS_SemWait, UOS_Delay and by the bus
+ *               cycle time of every register access. Interrupts and
+ *               alarms are delivered while the clock advances.
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+ ****************************************************************************/
+
+#ifndef _M76_SIM_H
+#define _M76_SIM_H
+
+#ifdef __cplusplus
+      extern "C" {
+#endif
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define M76SIM_SPACE_SIZE   256         /* size of module address space */
+#define M76SIM_UEE_WORDS    256         /* user EEPROM (93C66) */
+#define M76SIM_IDP_WORDS    64          /* ID PROM (93C46) */
+
+#define M76SIM_CHAN_ALL     -1          /* M76SIM_InputSet: all channels */
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+/* access and event counters of the module model */
+typedef struct {
+    u_int32     rd16;           /* register reads */
+    u_int32     wr16;           /* register writes */
+    u_int32     conv;           /* ADC conversions */
+    u_int32     cali;           /* ADC calibrations */
+    u_int32     xfer;           /* 24-bit transfers (TR24R) */
+    u_int32     irq;            /* interrupts raised */
+    u_int32     ueeRead;        /* user EEPROM word reads */
+    u_int32     ueeProg;        /* user EEPROM erase/write cycles */
+    u_int32     idpRead;        /* ID PROM word reads */
+} M76SIM_STAT;
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+/* module model (m76_sim.c) */
+extern MACCESS M76SIM_Init(void);
+extern int32   M76SIM_NextEvent(u_int64 nowNs, u_int64 *tP);
+extern int32   M76SIM_IrqLine(void);
+extern void    M76SIM_InputSet(int32 chan, double frac);
+extern void    M76SIM_NoiseSet(u_int32 counts);
+extern void    M76SIM_DriftSet(int32 counts);
+extern void    M76SIM_BusTimeSet(u_int32 ns);
+extern void    M76SIM_UeeGet(u_int16 *buf, u_int32 words);
+extern void    M76SIM_UeeSet(const u_int16 *buf, u_int32 words);
+extern void    M76SIM_StatGet(M76SIM_STAT *stat);
+
+/* virtual clock and interrupt (sim_oss.c) */
+extern u_int64 SIM_TimeNs(void);
+extern void    SIM_TimeSpend(u_int64 ns);
+extern void    SIM_TimeAdvance(u_int64 ns);
+extern void    SIM_IrqConnect(void (*isr)(void *arg), void *arg);
+extern void    SIM_SigHandlerSet(void (*handler)(int32 sig));
+
+/* MDIS kernel (sim_mdis.c) */
+extern void    SIM_DescSet(const SIM_DESC_ENTRY *desc);
+
+#ifdef __cplusplus
+      }
+#endif
+
+#endif /* _M76_SIM_H */
@@ -0,0 +1,499 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************
+ *
+ *         Name: sim_mdis.c
+ *      Project: M76 host simulation
+ *
+ *  Description: MDIS user API and kernel for the simulated M76
+ *               - M_open/M_close/M_read/M_getblock/M_setstat/M_getstat
+ *                 call the unmodified driver entry points (__M76_GetEntry)
+ *               - interrupt enable (M_MK_IRQ_ENABLE) connects M76_Irq to
+ *                 the module model
+ *               - UOS functions on the virtual clock
+ *               - UTL option parsing (-x, -x=<val>)
+ *
+ *               One device with any name can be opened (several paths).
+ *               The descriptor is set with SIM_DescSet() or taken from
+ *               environment variable M76_SIM_DESC, e.g.
+ *                 M76_SIM_DESC="ID_CHECK=1,CALI_POLICY=0,DEBUG_LEVEL=7"
+ *
+ *     Required: m76_sim.c, sim_oss.c, M76 driver
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MEN/men_typs.h>
+#include <MEN/maccess.h>
+#include <MEN/dbg.h>
+#include <MEN/oss.h>
+#include <MEN/desc.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_com.h>
+#include <MEN/mdis_err.h>
+#include <MEN/ll_defs.h>
+#include <MEN/ll_entry.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/m76_drv.h>
+#include "m76_sim.h"
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define MAX_PATHS       8
+#define MAX_DESC        32
+#define BLK_CODE(c)     ((c) & 0x1000)  /* block getstat/setstat */
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+typedef struct {
+    LL_ENTRY    entry;          /* driver branch table */
+    LL_HANDLE   *llHdl;
+    MACCESS     ma;
+    int32       irqEnable;
+    int32       openCnt;
+    int32       ch[MAX_PATHS];  /* current channel per path */
+    int32       used[MAX_PATHS];
+} SIM_DEV;
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+static SIM_DEV          G_dev;
+static int32            G_errno;
+static const SIM_DESC_ENTRY *G_desc;
+static SIM_DESC_ENTRY   G_envDesc[MAX_DESC+1];
+static char             G_envKeys[MAX_DESC][32];
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+static int32 Error(int32 err);
+static SIM_DEV *Path(MDIS_PATH path);
+static void Isr(void *arg);
+static const SIM_DESC_ENTRY *EnvDesc(void);
+
+/******************************** SIM_DescSet *******************************
+ *
+ *  Description: Set descriptor for next first M_open.
+ *---------------------------------------------------------------------------
+ *  Input......: desc       descriptor table (NULL: M76_SIM_DESC)
+ *  Output.....: -
+ *  Globals....: G_desc
+ ****************************************************************************/
+void SIM_DescSet(const SIM_DESC_ENTRY *desc)
+{
+    G_desc = desc;
+}
+
+/******************************** M_open ************************************
+ *
+ *  Description: Open path to device, init device on first open.
+ *---------------------------------------------------------------------------
+ *  Input......: device     device name (ignored)
+ *  Output.....: return     path number or -1 (error)
+ *  Globals....: G_dev
+ ****************************************************************************/
+MDIS_PATH M_open(const char *device)
+{
+    SIM_DEV *dev = &G_dev;
+    int32 i, error;
+
+    for (i=0; i<MAX_PATHS; i++)
+        if (!dev->used[i])
+            break;
+    if (i == MAX_PATHS)
+        return(Error(ERR_MK_ILL_PARAM));
+
+    if (dev->openCnt == 0)  {
+        __M76_GetEntry(&dev->entry);
+        dev->ma = M76SIM_Init();
+        dev->irqEnable = FALSE;
+
+        error = dev->entry.init((DESC_SPEC*)(G_desc ? G_desc : EnvDesc()),
+                                NULL, &dev->ma, NULL, NULL, &dev->llHdl);
+        if (error)
+            return(Error(error));
+    }
+    dev->openCnt++;
+    dev->used[i] = TRUE;
+    dev->ch[i]   = 0;
+    return(i);
+}
+
+/******************************** M_close ***********************************
+ *
+ *  Description: Close path, de-init device on last close.
+ *---------------------------------------------------------------------------
+ *  Input......: path       path number
+ *  Output.....: return     0 or -1 (error)
+ *  Globals....: G_dev
+ ****************************************************************************/
+int32 M_close(MDIS_PATH path)
+{
+    SIM_DEV *dev;
+    int32 error;
+
+    if ((dev = Path(path)) == NULL)
+        return(Error(ERR_MK_ILL_PARAM));
+
+    dev->used[path] = FALSE;
+    if (--dev->openCnt == 0)  {
+        SIM_IrqConnect(NULL, NULL);
+        if ((error = dev->entry.exit(&dev->llHdl)))
+            return(Error(error));
+    }
+    return(0);
+}
+
+int32 M_read(MDIS_PATH path, int32 *valueP)
+{
+    SIM_DEV *dev;
+    int32 error;
+
+    if ((dev = Path(path)) == NULL)
+        return(Error(ERR_MK_ILL_PARAM));
+
+    if ((error = dev->entry.read(dev->llHdl, dev->ch[path], valueP)))
+        return(Error(error));
+    return(0);
+}
+
+int32 M_write(MDIS_PATH path, int32 value)
+{
+    SIM_DEV *dev;
+    int32 error;
+
+    if ((dev = Path(path)) == NULL)
+        return(Error(ERR_MK_ILL_PARAM));
+
+    if ((error = dev->entry.write(dev->llHdl, dev->ch[path], value)))
+        return(Error(error));
+    return(0);
+}
+
+int32 M_getblock(MDIS_PATH path, u_int8 *buffer, int32 length)
+{
+    SIM_DEV *dev;
+    int32 error, n = 0;
+
+    if ((dev = Path(path)) == NULL)
+        return(Error(ERR_MK_ILL_PARAM));
+
+    if ((error = dev->entry.blockRead(dev->llHdl, dev->ch[path],
+                                      buffer, length, &n)))
+        return(Error(error));
+    return(n);
+}
+
+int32 M_setblock(MDIS_PATH path, const u_int8 *buffer, int32 length)
+{
+    SIM_DEV *dev;
+    int32 error, n = 0;
+
+    if ((dev = Path(path)) == NULL)
+        return(Error(ERR_MK_ILL_PARAM));
+
+    if ((error = dev->entry.blockWrite(dev->llHdl, dev->ch[path],
+                                       (void*)buffer, length, &n)))
+        return(Error(error));
+    return(n);
+}
+
+/******************************** M_setstat *********************************
+ *
+ *  Description: Set status. Block codes pass a M_SG_BLOCK pointer.
+ *---------------------------------------------------------------------------
+ *  Input......: path       path number
+ *               code       status code
+ *               data       value or M_SG_BLOCK pointer
+ *  Output.....: return     0 or -1 (error)
+ *  Globals....: G_dev
+ ****************************************************************************/
+int32 M_setstat(MDIS_PATH path, int32 code, INT32_OR_64 data)
+{
+    SIM_DEV *dev;
+    int32 error;
+
+    if ((dev = Path(path)) == NULL)
+        return(Error(ERR_MK_ILL_PARAM));
+
+    switch (code)  {
+    case M_MK_CH_CURRENT:
+        dev->ch[path] = (int32)data;
+        return(0);
+    case M_MK_IRQ_ENABLE:
+        dev->irqEnable = data ? TRUE : FALSE;
+        SIM_IrqConnect(dev->irqEnable ? Isr : NULL, dev);
+        break;          /* pass to driver */
+    }
+    if ((code & 0xff00) == M_MK_OF)
+        if (code != M_MK_IRQ_ENABLE)
+            return(Error(ERR_MK_UNK_CODE));
+
+    if ((error = dev->entry.setStat(dev->llHdl, code, dev->ch[path], data)))
+        return(Error(error));
+    return(0);
+}
+
+/******************************** M_getstat *********************************
+ *
+ *  Description: Get status. Block codes pass a M_SG_BLOCK pointer.
+ *---------------------------------------------------------------------------
+ *  Input......: path       path number
+ *               code       status code
+ *               dataP      value or M_SG_BLOCK pointer
+ *  Output.....: return     0 or -1 (error)
+ *  Globals....: G_dev
+ ****************************************************************************/
+int32 M_getstat(MDIS_PATH path, int32 code, int32 *dataP)
+{
+    SIM_DEV *dev;
+    INT32_OR_64 val;
+    int32 error;
+
+    if ((dev = Path(path)) == NULL)
+        return(Error(ERR_MK_ILL_PARAM));
+
+    switch (code)  {
+    case M_MK_CH_CURRENT:
+        *dataP = dev->ch[path];
+        return(0);
+    case M_MK_IRQ_ENABLE:
+        *dataP = dev->irqEnable;
+        return(0);
+    }
+    if ((code & 0xff00) == M_MK_OF)
+        return(Error(ERR_MK_UNK_CODE));
+
+    if (BLK_CODE(code))  {
+        error = dev->entry.getStat(dev->llHdl, code, dev->ch[path],
+                                   (INT32_OR_64*)dataP);
+    }
+    else  {
+        val = *dataP;   /* some codes take an input value (M76_CALI) */
+        error = dev->entry.getStat(dev->llHdl, code, dev->ch[path], &val);
+        *dataP = (int32)val;
+    }
+    if (error)
+        return(Error(error));
+    return(0);
+}
+
+/******************************** M_errstring *******************************
+ *
+ *  Description: Get error message.
+ *---------------------------------------------------------------------------
+ *  Input......: errCode    error code
+ *  Output.....: return     message
+ *  Globals....: -
+ ****************************************************************************/
+char *M_errstring(int32 errCode)
+{
+    static char buf[80];
+    static const struct { int32 code; const char *msg; } tbl[] = {
+        { ERR_OSS_MEM_ALLOC,    "OSS: can't allocate memory" },
+        { ERR_OSS_TIMEOUT,      "OSS: timeout" },
+        { ERR_OSS_SIG_SET,      "OSS: signal already installed" },
+        { ERR_OSS_SIG_CLR,      "OSS: signal not installed" },
+        { ERR_DESC_KEY_NOTFOUND,"DESC: key not found" },
+        { ERR_ID,               "ID: can't read ID PROM" },
+        { ERR_MK_ILL_PARAM,     "MK: illegal parameter" },
+        { ERR_MK_UNK_CODE,      "MK: unknown status code" },
+        { ERR_LL_ILL_PARAM,     "LL: illegal parameter" },
+        { ERR_LL_ILL_ID,        "LL: illegal module id" },
+        { ERR_LL_ILL_DIR,       "LL: illegal channel direction" },
+        { ERR_LL_ILL_FUNC,      "LL: function not supported" },
+        { ERR_LL_UNK_CODE,      "LL: unknown status code" },
+        { ERR_LL_USERBUF,       "LL: user buffer too small" },
+        { ERR_LL_DEV_NOTRDY,    "LL: device not ready" },
+        { ERR_LL_DEV_BUSY,      "LL: device busy" },
+        { ERR_LL_READ,          "LL: read error" },
+        { ERR_LL_WRITE,         "LL: write error" },
+        { ERR_LL_ILL_CHAN,      "LL: illegal channel" },
+        { 0, NULL }
+    };
+    int32 i;
+
+    for (i=0; tbl[i].msg; i++)
+        if (tbl[i].code == errCode)
+            break;
+
+    sprintf(buf, "ERROR (SIM) 0x%04x: %s", (unsigned)errCode,
+            tbl[i].msg ? tbl[i].msg : "unknown error");
+    return(buf);
+}
+
+/*---------------------------------------------------------------------------
+ * UOS
+ *--------------------------------------------------------------------------*/
+
+int32 UOS_ErrnoGet(void)
+{
+    return(G_errno);
+}
+
+int32 UOS_KeyWait(void)
+{
+    int c = getchar();
+
+    while (c == '\n')
+        c = getchar();
+    return(c == EOF ? -1 : c);
+}
+
+int32 UOS_KeyPressed(void)
+{
+    return(-1);
+}
+
+int32 UOS_Delay(u_int32 msec)
+{
+    SIM_TimeAdvance((u_int64)msec * 1000000);
+    return(0);
+}
+
+u_int32 UOS_MsecTimerGet(void)
+{
+    return((u_int32)(SIM_TimeNs() / 1000000));
+}
+
+u_int32 UOS_MsecTimerResolution(void)
+{
+    return(1);
+}
+
+/*---------------------------------------------------------------------------
+ * UTL
+ *--------------------------------------------------------------------------*/
+
+/******************************** UTL_Tstopt ********************************
+ *
+ *  Description: Test for option -<c> or -<c>=<val>.
+ *---------------------------------------------------------------------------
+ *  Input......: argc,argv  arguments
+ *               option     "c" (flag) or "c=" (with value)
+ *               buf        buffer for value
+ *  Output.....: return     value (flag: empty string) or NULL
+ *  Globals....: -
+ ****************************************************************************/
+char *UTL_Tstopt(int argc, char **argv, char *option, char *buf)
+{
+    int n;
+
+    for (n=1; n<argc; n++)  {
+        if ((argv[n][0] != '-') || (argv[n][1] != option[0]))
+            continue;
+        if (option[1] == '=')  {
+            if (argv[n][2] != '=')
+                continue;
+            strcpy(buf, &argv[n][3]);
+        }
+        else
+            *buf = '\0';
+        return(buf);
+    }
+    return(NULL);
+}
+
+/******************************** UTL_Illiopt *******************************
+ *
+ *  Description: Check for illegal options.
+ *---------------------------------------------------------------------------
+ *  Input......: argc,argv  arguments
+ *               opts       legal options, e.g. "a=b=il?"
+ *               errstr     buffer for error message
+ *  Output.....: return     error message or NULL
+ *  Globals....: -
+ ****************************************************************************/
+char *UTL_Illiopt(int argc, char **argv, char *opts, char *errstr)
+{
+    char *p;
+    int n;
+
+    for (n=1; n<argc; n++)  {
+        if (argv[n][0] != '-')
+            continue;
+        p = (argv[n][1] != '\0') ? strchr(opts, argv[n][1]) : NULL;
+        if ((p == NULL) || (*p == '=') ||
+            ((p[1] == '=') != (argv[n][2] == '=')) ||
+            ((p[1] != '=') && (argv[n][2] != '\0')))  {
+            sprintf(errstr, "illegal option: %s", argv[n]);
+            return(errstr);
+        }
+    }
+    return(NULL);
+}
+
+/*---------------------------------------------------------------------------
+ * internal
+ *--------------------------------------------------------------------------*/
+
+static int32 Error(int32 err)
+{
+    G_errno = err;
+    return(-1);
+}
+
+static SIM_DEV *Path(MDIS_PATH path)
+{
+    if (path < 0 || path >= MAX_PATHS || !G_dev.used[path])
+        return(NULL);
+    return(&G_dev);
+}
+
+/******************************** Isr ***************************************
+ *
+ *  Description: Interrupt of module model: call driver's M76_Irq.
+ *---------------------------------------------------------------------------
+ *  Input......: arg        device
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void Isr(void *arg)
+{
+    SIM_DEV *dev = (SIM_DEV*)arg;
+
+    dev->entry.irq(dev->llHdl);
+}
+
+/******************************** EnvDesc ***********************************
+ *
+ *  Description: Build descriptor from M76_SIM_DESC="KEY=VAL,...".
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     descriptor table
+ *  Globals....: G_envDesc, G_envKeys
+ ****************************************************************************/
+static const SIM_DESC_ENTRY *EnvDesc(void)
+{
+    const char *env = getenv("M76_SIM_DESC");
+    const char *p = env;
+    int32 n = 0, len;
+
+    memset(G_envDesc, 0, sizeof(G_envDesc));
+
+    while (p && *p && n < MAX_DESC)  {
+        len = (int32)strcspn(p, "=,");
+        if (len >= (int32)sizeof(G_envKeys[0]))
+            len = sizeof(G_envKeys[0]) - 1;
+        memcpy(G_envKeys[n], p, len);
+        G_envKeys[n][len] = '\0';
+        p += strcspn(p, "=,");
+
+        G_envDesc[n].key = G_envKeys[n];
+        if (*p == '=')
+            G_envDesc[n].value = (u_int32)strtoul(p+1, NULL, 0);
+        n++;
+
+        p += strcspn(p, ",");
+        if (*p == ',')
+            p++;
+    }
+    return(G_envDesc);
+}
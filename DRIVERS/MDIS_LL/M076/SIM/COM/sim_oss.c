@@ -0,0 +1,712 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************
+ *
+ *         Name: sim_oss.c
+ *      Project: M76 host simulation
+ *
+ *  Description: Host implementation of the libraries used by the driver
+ *               - OSS with virtual clock, alarms, semaphores, signals
+ *               - DESC on SIM_DESC_ENTRY tables
+ *               - DBG output to stderr
+ *               - MCRW port library (microwire bit-banging via MACCESS)
+ *
+ *               The clock advances only in delays and waits. Pending
+ *               interrupts of the module model and expired alarms are
+ *               handled while the clock advances, in time order.
+ *
+ *     Required: m76_sim.c
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <MEN/men_typs.h>
+#include <MEN/maccess.h>
+#include <MEN/dbg.h>
+#include <MEN/oss.h>
+#include <MEN/desc.h>
+#include <MEN/mdis_err.h>
+#include <MEN/microwire.h>
+#include "m76_sim.h"
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define MAX_ALARMS      8
+#define NS_PER_MS       1000000ULL
+#define NO_TIME         ((u_int64)-1)
+
+/* microwire opcodes (incl. start bit) */
+#define MW_READ         0x6
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+struct OSS_ALARM_HANDLE {
+    void        (*funct)(void *arg);
+    void        *arg;
+    u_int32     active;
+    u_int64     tExp;           /* expiration time */
+    u_int64     period;         /* cyclic period (0=single) */
+};
+
+struct OSS_SEM_HANDLE {
+    int32       type;
+    volatile int32 count;
+};
+
+struct OSS_SIG_HANDLE {
+    int32       sig;
+};
+
+struct DESC_HANDLE {
+    const SIM_DESC_ENTRY *tbl;
+    u_int32     dbgLevel;
+};
+
+typedef struct {
+    MCRW_HANDLE ent;            /* must be first */
+    MACCESS     ma;             /* PLD_IF register */
+    u_int32     addrLength;
+    u_int32     busClock;
+    u_int16     mDat, mClk, mCs, mIn;
+    OSS_HANDLE  *osHdl;
+} SIM_MCRW;
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+static u_int64          G_time;                 /* virtual time [ns] */
+static OSS_ALARM_HANDLE *G_alarm[MAX_ALARMS];
+static void             (*G_isr)(void *arg);
+static void             *G_isrArg;
+static int32            G_irqMasked;
+static int32            G_inIsr;
+static void             (*G_sigHandler)(int32 sig);
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+static void  Run(u_int64 end, volatile int32 *cond);
+static int32 NextEvent(u_int64 *tP);
+static int32 Events(void);
+static int32 McrwExit(void **hdlP);
+static int32 McrwReadEeprom(void *hdl, u_int16 addr, u_int16 *buf, u_int16 size);
+static char  *McrwIdent(void);
+static void  McrwOut(SIM_MCRW *mw, u_int16 val);
+static int32 McrwClock(SIM_MCRW *mw, int32 di);
+
+/*---------------------------------------------------------------------------
+ * virtual clock
+ *--------------------------------------------------------------------------*/
+
+/******************************** SIM_TimeNs ********************************
+ *
+ *  Description: Get virtual time.
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     time since start [ns]
+ *  Globals....: G_time
+ ****************************************************************************/
+u_int64 SIM_TimeNs(void)
+{
+    return(G_time);
+}
+
+/******************************** SIM_TimeSpend *****************************
+ *
+ *  Description: Advance virtual time without handling events
+ *               (bus cycles, CPU time).
+ *---------------------------------------------------------------------------
+ *  Input......: ns         time [ns]
+ *  Output.....: -
+ *  Globals....: G_time
+ ****************************************************************************/
+void SIM_TimeSpend(u_int64 ns)
+{
+    G_time += ns;
+}
+
+/******************************** SIM_TimeAdvance ***************************
+ *
+ *  Description: Advance virtual time and handle interrupts and alarms.
+ *---------------------------------------------------------------------------
+ *  Input......: ns         time [ns]
+ *  Output.....: -
+ *  Globals....: G_time
+ ****************************************************************************/
+void SIM_TimeAdvance(u_int64 ns)
+{
+    Run(G_time + ns, NULL);
+}
+
+/******************************** SIM_IrqConnect ****************************
+ *
+ *  Description: Install interrupt service routine of module (NULL=none).
+ *---------------------------------------------------------------------------
+ *  Input......: isr        interrupt routine
+ *               arg        argument of isr
+ *  Output.....: -
+ *  Globals....: G_isr, G_isrArg
+ ****************************************************************************/
+void SIM_IrqConnect(void (*isr)(void *arg), void *arg)
+{
+    G_isr    = isr;
+    G_isrArg = arg;
+}
+
+/******************************** SIM_SigHandlerSet *************************
+ *
+ *  Description: Install handler for signals sent with OSS_SigSend.
+ *---------------------------------------------------------------------------
+ *  Input......: handler    signal handler (NULL=none)
+ *  Output.....: -
+ *  Globals....: G_sigHandler
+ ****************************************************************************/
+void SIM_SigHandlerSet(void (*handler)(int32 sig))
+{
+    G_sigHandler = handler;
+}
+
+/******************************** Run ***************************************
+ *
+ *  Description: Advance time to end, handle events in time order.
+ *               Stop early if *cond becomes non-zero.
+ *---------------------------------------------------------------------------
+ *  Input......: end        end time
+ *               cond       condition to wait for (or NULL)
+ *  Output.....: -
+ *  Globals....: G_time, G_alarm
+ ****************************************************************************/
+static void Run(u_int64 end, volatile int32 *cond)
+{
+    u_int64 t;
+
+    for (;;)  {
+        while (Events())
+            ;
+        if ((cond && *cond) || (G_time >= end))
+            break;
+
+        /* next event, events which can't be handled now are skipped */
+        if (!NextEvent(&t) || (t > end) || (t <= G_time))
+            t = end;
+
+        G_time = t;
+    }
+}
+
+/******************************** NextEvent *********************************
+ *
+ *  Description: Get time of next interrupt or alarm in the future.
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: *tP        time of event
+ *               return     TRUE if event pending
+ *  Globals....: G_alarm
+ ****************************************************************************/
+static int32 NextEvent(u_int64 *tP)
+{
+    u_int64 t = NO_TIME, tEv;
+    int32 i;
+
+    if (M76SIM_NextEvent(G_time, &tEv))
+        t = tEv;
+    for (i=0; i<MAX_ALARMS; i++)
+        if (G_alarm[i] && G_alarm[i]->active &&
+            (G_alarm[i]->tExp > G_time) && (G_alarm[i]->tExp < t))
+            t = G_alarm[i]->tExp;
+
+    *tP = t;
+    return(t != NO_TIME);
+}
+
+/******************************** Events ************************************
+ *
+ *  Description: Handle pending interrupt and expired alarms.
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return     TRUE if something was handled
+ *  Globals....: G_alarm, G_isr
+ ****************************************************************************/
+static int32 Events(void)
+{
+    OSS_ALARM_HANDLE *al;
+    int32 i, done = FALSE;
+    u_int64 dummy;
+
+    if (G_inIsr || G_irqMasked)
+        return(FALSE);
+
+    G_inIsr = TRUE;
+
+    M76SIM_NextEvent(G_time, &dummy);   /* update model */
+    if (G_isr && M76SIM_IrqLine())  {
+        G_isr(G_isrArg);
+        done = TRUE;
+    }
+
+    for (i=0; i<MAX_ALARMS; i++)  {
+        al = G_alarm[i];
+        if (al && al->active && (al->tExp <= G_time))  {
+            if (al->period)
+                al->tExp += al->period;
+            else
+                al->active = FALSE;
+            al->funct(al->arg);
+            done = TRUE;
+        }
+    }
+
+    G_inIsr = FALSE;
+
+    /* unhandled interrupt line would loop forever */
+    if (done && G_isr && M76SIM_IrqLine())
+        done = FALSE;
+
+    return(done);
+}
+
+/*---------------------------------------------------------------------------
+ * OSS
+ *--------------------------------------------------------------------------*/
+
+char *OSS_Ident(void)
+{
+    return("OSS - host simulation (virtual clock)");
+}
+
+void *OSS_MemGet(OSS_HANDLE *os, u_int32 size, u_int32 *gotsizeP)
+{
+    void *p = malloc(size);
+
+    *gotsizeP = p ? size : 0;
+    return(p);
+}
+
+int32 OSS_MemFree(OSS_HANDLE *os, void *addr, u_int32 size)
+{
+    free(addr);
+    return(0);
+}
+
+void OSS_MemFill(OSS_HANDLE *os, u_int32 size, char *adr, int8 value)
+{
+    memset(adr, value, size);
+}
+
+void OSS_MemCopy(OSS_HANDLE *os, u_int32 size, char *src, char *dest)
+{
+    memcpy(dest, src, size);
+}
+
+int32 OSS_Delay(OSS_HANDLE *os, int32 msec)
+{
+    SIM_TimeAdvance((u_int64)msec * NS_PER_MS);
+    return(msec);
+}
+
+int32 OSS_MikroDelay(OSS_HANDLE *os, u_int32 usec)
+{
+    SIM_TimeAdvance((u_int64)usec * 1000);
+    return(0);
+}
+
+int32 OSS_TickGet(OSS_HANDLE *os)
+{
+    return((int32)(G_time / NS_PER_MS));
+}
+
+int32 OSS_TickRateGet(OSS_HANDLE *os)
+{
+    return(1000);
+}
+
+/******************************** OSS_SemWait *******************************
+ *
+ *  Description: Wait for semaphore, advances virtual time until semaphore
+ *               is signaled by an interrupt or alarm, or timeout.
+ *               OSS_SEM_WAITFOREVER returns ERR_OSS_TIMEOUT if no event
+ *               is pending (deadlock in simulation).
+ *---------------------------------------------------------------------------
+ *  Input......: os         OSS handle
+ *               sem        semaphore
+ *               msec       timeout [ms], 0=no wait
+ *  Output.....: return     0 | ERR_OSS_TIMEOUT
+ *  Globals....: -
+ ****************************************************************************/
+int32 OSS_SemWait(OSS_HANDLE *os, OSS_SEM_HANDLE *sem, int32 msec)
+{
+    u_int64 t;
+
+    if (msec > 0)
+        Run(G_time + (u_int64)msec * NS_PER_MS, &sem->count);
+    else if (msec < 0)  {
+        while (sem->count == 0 && NextEvent(&t) && (t > G_time))
+            Run(t, &sem->count);
+    }
+
+    if (sem->count == 0)
+        return(ERR_OSS_TIMEOUT);
+
+    if (sem->type == OSS_SEM_BIN)
+        sem->count = 0;
+    else
+        sem->count--;
+
+    return(0);
+}
+
+int32 OSS_SemCreate(OSS_HANDLE *os, int32 semType, int32 initVal,
+                    OSS_SEM_HANDLE **semP)
+{
+    if ((*semP = (OSS_SEM_HANDLE*)calloc(1, sizeof(**semP))) == NULL)
+        return(ERR_OSS_MEM_ALLOC);
+
+    (*semP)->type  = semType;
+    (*semP)->count = initVal;
+    return(0);
+}
+
+int32 OSS_SemRemove(OSS_HANDLE *os, OSS_SEM_HANDLE **semP)
+{
+    free(*semP);
+    *semP = NULL;
+    return(0);
+}
+
+int32 OSS_SemSignal(OSS_HANDLE *os, OSS_SEM_HANDLE *sem)
+{
+    if (sem->type == OSS_SEM_BIN)
+        sem->count = 1;
+    else
+        sem->count++;
+    return(0);
+}
+
+int32 OSS_SigCreate(OSS_HANDLE *os, int32 signal, OSS_SIG_HANDLE **sigP)
+{
+    if ((*sigP = (OSS_SIG_HANDLE*)calloc(1, sizeof(**sigP))) == NULL)
+        return(ERR_OSS_MEM_ALLOC);
+
+    (*sigP)->sig = signal;
+    return(0);
+}
+
+int32 OSS_SigRemove(OSS_HANDLE *os, OSS_SIG_HANDLE **sigP)
+{
+    free(*sigP);
+    *sigP = NULL;
+    return(0);
+}
+
+int32 OSS_SigSend(OSS_HANDLE *os, OSS_SIG_HANDLE *sig)
+{
+    if (G_sigHandler)
+        G_sigHandler(sig->sig);
+    return(0);
+}
+
+int32 OSS_AlarmCreate(OSS_HANDLE *os, void (*funct)(void *arg), void *arg,
+                      OSS_ALARM_HANDLE **alarmP)
+{
+    int32 i;
+
+    for (i=0; i<MAX_ALARMS; i++)
+        if (G_alarm[i] == NULL)
+            break;
+    if (i == MAX_ALARMS)
+        return(ERR_OSS_MEM_ALLOC);
+
+    if ((*alarmP = (OSS_ALARM_HANDLE*)calloc(1, sizeof(**alarmP))) == NULL)
+        return(ERR_OSS_MEM_ALLOC);
+
+    (*alarmP)->funct = funct;
+    (*alarmP)->arg   = arg;
+    G_alarm[i] = *alarmP;
+    return(0);
+}
+
+int32 OSS_AlarmRemove(OSS_HANDLE *os, OSS_ALARM_HANDLE **alarmP)
+{
+    int32 i;
+
+    for (i=0; i<MAX_ALARMS; i++)
+        if (G_alarm[i] == *alarmP)
+            G_alarm[i] = NULL;
+
+    free(*alarmP);
+    *alarmP = NULL;
+    return(0);
+}
+
+int32 OSS_AlarmSet(OSS_HANDLE *os, OSS_ALARM_HANDLE *alarm, u_int32 msec,
+                   u_int32 cyclic, u_int32 *realMsecP)
+{
+    if (alarm->active)
+        return(ERR_OSS_ALARM_SET);
+
+    if (msec == 0)
+        msec = 1;
+    alarm->tExp   = G_time + (u_int64)msec * NS_PER_MS;
+    alarm->period = cyclic ? (u_int64)msec * NS_PER_MS : 0;
+    alarm->active = TRUE;
+    *realMsecP = msec;
+    return(0);
+}
+
+int32 OSS_AlarmClear(OSS_HANDLE *os, OSS_ALARM_HANDLE *alarm)
+{
+    if (!alarm->active)
+        return(ERR_OSS_ALARM_CLR);
+
+    alarm->active = FALSE;
+    return(0);
+}
+
+OSS_IRQ_STATE OSS_IrqMaskR(OSS_HANDLE *os, OSS_IRQ_HANDLE *irq)
+{
+    OSS_IRQ_STATE old = G_irqMasked;
+
+    G_irqMasked = TRUE;
+    return(old);
+}
+
+void OSS_IrqRestore(OSS_HANDLE *os, OSS_IRQ_HANDLE *irq, OSS_IRQ_STATE state)
+{
+    G_irqMasked = state;
+}
+
+/*---------------------------------------------------------------------------
+ * DESC
+ *--------------------------------------------------------------------------*/
+
+char *DESC_Ident(void)
+{
+    return("DESC - host simulation");
+}
+
+int32 DESC_Init(DESC_SPEC *descSpec, OSS_HANDLE *osHdl, DESC_HANDLE **descHdlP)
+{
+    if ((*descHdlP = (DESC_HANDLE*)calloc(1, sizeof(**descHdlP))) == NULL)
+        return(ERR_OSS_MEM_ALLOC);
+
+    (*descHdlP)->tbl = descSpec;
+    return(0);
+}
+
+int32 DESC_Exit(DESC_HANDLE **descHdlP)
+{
+    free(*descHdlP);
+    *descHdlP = NULL;
+    return(0);
+}
+
+int32 DESC_DbgLevelSet(DESC_HANDLE *descHdl, u_int32 dbgLevel)
+{
+    descHdl->dbgLevel = dbgLevel;
+    return(0);
+}
+
+/******************************** DescFind **********************************
+ *
+ *  Description: Find descriptor key.
+ *---------------------------------------------------------------------------
+ *  Input......: descHdl    descriptor handle
+ *               key        key name
+ *               bin        TRUE: binary key
+ *  Output.....: return     entry or NULL
+ *  Globals....: -
+ ****************************************************************************/
+static const SIM_DESC_ENTRY *DescFind(DESC_HANDLE *descHdl, const char *key,
+                                      int32 bin)
+{
+    const SIM_DESC_ENTRY *e;
+
+    for (e = descHdl->tbl; e && e->key; e++)
+        if (!strcmp(e->key, key) && ((e->bin != NULL) == (bin != 0)))
+            return(e);
+
+    return(NULL);
+}
+
+int32 DESC_GetUInt32(DESC_HANDLE *descHdl, u_int32 defVal, u_int32 *valueP,
+                     char *keyFmt, ...)
+{
+    const SIM_DESC_ENTRY *e;
+    char key[64];
+    va_list ap;
+
+    va_start(ap, keyFmt);
+    vsnprintf(key, sizeof(key), keyFmt, ap);
+    va_end(ap);
+
+    if ((e = DescFind(descHdl, key, FALSE)) == NULL)  {
+        *valueP = defVal;
+        return(ERR_DESC_KEY_NOTFOUND);
+    }
+    *valueP = e->value;
+    return(0);
+}
+
+int32 DESC_GetBinary(DESC_HANDLE *descHdl, u_int8 *defVal, u_int32 defLen,
+                     u_int8 *buf, u_int32 *lenP, char *keyFmt, ...)
+{
+    const SIM_DESC_ENTRY *e;
+    char key[64];
+    va_list ap;
+
+    va_start(ap, keyFmt);
+    vsnprintf(key, sizeof(key), keyFmt, ap);
+    va_end(ap);
+
+    if ((e = DescFind(descHdl, key, TRUE)) == NULL)  {
+        if (defLen > *lenP)
+            return(ERR_DESC_BUF_TOOSMALL);
+        memcpy(buf, defVal, defLen);
+        *lenP = defLen;
+        return(ERR_DESC_KEY_NOTFOUND);
+    }
+    if (e->binLen > *lenP)
+        return(ERR_DESC_BUF_TOOSMALL);
+
+    memcpy(buf, e->bin, e->binLen);
+    *lenP = e->binLen;
+    return(0);
+}
+
+/*---------------------------------------------------------------------------
+ * DBG
+ *--------------------------------------------------------------------------*/
+
+int32 DBG_Init(char *name, DBG_HANDLE **dbgP)
+{
+    *dbgP = NULL;
+    return(0);
+}
+
+int32 DBG_Exit(DBG_HANDLE **dbgP)
+{
+    *dbgP = NULL;
+    return(0);
+}
+
+int32 DBG_Write(DBG_HANDLE *dbg, char *fmt, ...)
+{
+    va_list ap;
+
+    fprintf(stderr, "[%10.3f ms] ", G_time / 1e6);
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    return(0);
+}
+
+/*---------------------------------------------------------------------------
+ * MCRW port library (read only)
+ *--------------------------------------------------------------------------*/
+
+/******************************** MCRW_PORT_Init ****************************
+ *
+ *  Description: Create microwire handle for EEPROM on a port register.
+ *               Data in/out, clock and CS must be in the same register
+ *               (MCRW_DESC_PORT_FLAG_OUT_IN_ONE_REG).
+ *---------------------------------------------------------------------------
+ *  Input......: desc       port description
+ *               osHdl      OSS handle
+ *  Output.....: *hdlP      microwire handle
+ *               return     0 | error code
+ *  Globals....: -
+ ****************************************************************************/
+int32 MCRW_PORT_Init(MCRW_DESC_PORT *desc, OSS_HANDLE *osHdl, void **hdlP)
+{
+    SIM_MCRW *mw;
+
+    *hdlP = NULL;
+    if (!(desc->flagsOut & MCRW_DESC_PORT_FLAG_OUT_IN_ONE_REG))
+        return(ERR_ID);
+
+    if ((mw = (SIM_MCRW*)calloc(1, sizeof(*mw))) == NULL)
+        return(ERR_OSS_MEM_ALLOC);
+
+    mw->ent.Exit       = McrwExit;
+    mw->ent.ReadEeprom = McrwReadEeprom;
+    mw->ent.Ident      = McrwIdent;
+    mw->ma         = (MACCESS)desc->addrDataOut;
+    mw->addrLength = desc->addrLength;
+    mw->busClock   = desc->busClock;
+    mw->mDat       = (u_int16)desc->maskDataOut;
+    mw->mClk       = (u_int16)desc->maskClockOut;
+    mw->mCs        = (u_int16)desc->maskCsOut;
+    mw->mIn        = (u_int16)desc->maskDataIn;
+    mw->osHdl      = osHdl;
+
+    *hdlP = mw;
+    return(0);
+}
+
+static int32 McrwExit(void **hdlP)
+{
+    free(*hdlP);
+    *hdlP = NULL;
+    return(0);
+}
+
+static char *McrwIdent(void)
+{
+    return("MCRW_PORT - host simulation");
+}
+
+static void McrwOut(SIM_MCRW *mw, u_int16 val)
+{
+    MWRITE_D16(mw->ma, 0, val);
+    OSS_MikroDelay(mw->osHdl, mw->busClock);
+}
+
+static int32 McrwClock(SIM_MCRW *mw, int32 di)
+{
+    u_int16 d = di ? mw->mDat : 0;
+
+    McrwOut(mw, mw->mCs | d);
+    McrwOut(mw, mw->mCs | d | mw->mClk);
+    return( (MREAD_D16(mw->ma, 0) & mw->mIn) ? 1 : 0 );
+}
+
+/******************************** McrwReadEeprom ****************************
+ *
+ *  Description: Read words from EEPROM.
+ *---------------------------------------------------------------------------
+ *  Input......: hdl        microwire handle
+ *               addr       first word address
+ *               size       number of bytes
+ *  Output.....: buf        read words
+ *               return     0
+ *  Globals....: -
+ ****************************************************************************/
+static int32 McrwReadEeprom(void *hdl, u_int16 addr, u_int16 *buf, u_int16 size)
+{
+    SIM_MCRW *mw = (SIM_MCRW*)hdl;
+    u_int32 cmd;
+    u_int16 w;
+    int32 i, n;
+
+    for (n = 0; n < size/2; n++, addr++)  {
+        McrwOut(mw, 0);
+        McrwOut(mw, mw->mCs);
+
+        cmd = ((u_int32)MW_READ << mw->addrLength) | addr;
+        for (i = mw->addrLength + 2; i >= 0; i--)
+            McrwClock(mw, (cmd >> i) & 1);
+
+        for (w = 0, i = 0; i < 16; i++)
+            w = (u_int16)((w << 1) | McrwClock(mw, 0));
+        *buf++ = w;
+
+        McrwOut(mw, 0);
+    }
+    return(0);
+}
@@ -0,0 +1,616 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                    M76_BENCH                       ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *  Description: Benchmark of the M76 driver
+ *               - init time (first open of device)
+ *               - M_read throughput and per-sample latency percentiles
+ *                 for polled and interrupt mode across filter values
+ *               - M_getblock throughput (resistance range)
+ *               - range switch time per transition pair
+ *               - calibration (M76_CALI) and store (M76_STORE_CALI) time
+ *
+ *               Results are printed one record per line:
+ *                 <record> <key>=<value> ...
+ *               Comment lines start with '#'. Times are in usec.
+ *
+ *               Calibration values detected by M76_CALI are discarded,
+ *               the calibration memory is exported before and imported
+ *               again afterwards (M76_BLK_CALI_BLOB).
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl
+ *     Switches: M76_SIM    use virtual clock of host simulation
+ *                          (usec resolution instead of msec)
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MEN/men_typs.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/mdis_api.h>
+#include <MEN/m76_drv.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define MAX_SAMPLES		100000
+#define MAX_LIST		32
+#define STORE_KEY		0x3730		/* M76_STORE_CALI value */
+
+/* polled, interrupt */
+#define MODE_POLL		0x1
+#define MODE_IRQ		0x2
+
+/*--------------------------------------+
+|   TYPDEFS                             |
++--------------------------------------*/
+/* none */
+
+/*--------------------------------------+
+|   EXTERNALS                           |
++--------------------------------------*/
+#ifdef M76_SIM
+extern u_int64 SIM_TimeNs(void);
+#endif
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static const char *G_modeStr[] = { "", "poll", "irq" };
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void usage(void);
+static void PrintMdisError(char *info);
+static double TimeUs(void);
+static int32 ParseList(char *str, u_int32 *list, int32 max);
+static int CmpDouble(const void *a, const void *b);
+static void PrintLatency(double *lat, u_int32 n, double total);
+static int32 BenchRead(MDIS_PATH path, u_int32 mode, u_int32 filter,
+					   u_int32 range, u_int32 n, double *lat);
+static int32 BenchBlock(MDIS_PATH path, u_int32 mode, u_int32 range,
+						u_int32 n, double *lat);
+static int32 BenchSwitch(MDIS_PATH path, u_int32 *ranges, int32 nRanges);
+static int32 BenchCali(MDIS_PATH path, u_int32 range);
+static int32 BenchStore(MDIS_PATH path);
+
+/********************************* usage ************************************
+ *
+ *  Description: Print program usage
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void usage(void)
+{
+	printf("Usage: m76_bench [<opts>] <device> [<opts>]\n");
+	printf("Function: Benchmark of the M76 driver\n");
+	printf("\n");
+	printf("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!\n");
+	printf("!! The benchmark switches all given ranges. Disconnect   !!\n");
+	printf("!! the inputs of the M-Module before running it!         !!\n");
+	printf("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!\n");
+	printf("\n");
+	printf("Options:\n");
+	printf("  device       device name....................... [none]\n");
+	printf("  -n=<num>     samples per read test ............ [50]\n");
+	printf("  -m=<mode>    1=polled, 2=interrupt, 3=both .... [3]\n");
+	printf("  -f=<list>    filter values (20..1920) ......... [1920,480,120,20]\n");
+	printf("  -r=<range>   range of read tests .............. [2]\n");
+	printf("  -b=<range>   range of block read test, 0=none . [17]\n");
+	printf("  -x=<list>    ranges of switch test, 0=none .... [2,8,10,14,17,22]\n");
+	printf("  -k=<range>   range of calibration test ........ [2]\n");
+	printf("               (values are discarded), -k=-1: no test\n");
+	printf("  -s=<ms>      settling time ..................... [driver default]\n");
+	printf("  -c           measure M76_STORE_CALI ........... [no]\n");
+	printf("               (rewrites user EEPROM with current values)\n");
+	printf("\n");
+	printf("Output: one record per line, <record> <key>=<value> ...\n");
+	printf("  init   open_us\n");
+	printf("  read   mode filter range n sps min_us p50_us p90_us p99_us max_us\n");
+	printf("  block  mode range n sps min_us p50_us p90_us p99_us max_us\n");
+	printf("  switch from to set_us first_us\n");
+	printf("  cali   range kind us\n");
+	printf("  store  us\n");
+	printf("  error  op msg\n");
+	printf("\n");
+	printf("(c) 2026 by MEN Mikro Elektronik GmbH\n\n");
+}
+
+/********************************* main *************************************
+ *
+ *  Description: Program main function
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: argc,argv	argument counter, data ..
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	MDIS_PATH	path=0;
+	int32	n, i, nFilters, nRanges, caliRange, error=0;
+	u_int32 samples, modes, range, blkRange, sTime, store, mode;
+	u_int32 filters[MAX_LIST], ranges[MAX_LIST];
+	u_int32 oldRange, oldFilter;
+	char	*device, *str, *errstr, buf[80];
+	char	fDefault[] = "1920,480,120,20", xDefault[] = "2,8,10,14,17,22";
+	double	t0, *lat=NULL;
+
+	/*--------------------+
+    |  check arguments    |
+    +--------------------*/
+	if ((errstr = UTL_ILLIOPT("n=m=f=r=b=x=k=s=c?", buf))) {	/* check args */
+		printf("*** %s\n", errstr);
+		return(1);
+	}
+
+	if (UTL_TSTOPT("?")) {						/* help requested ? */
+		usage();
+		return(1);
+	}
+
+	/*--------------------+
+    |  get arguments      |
+    +--------------------*/
+	for (device=NULL, n=1; n<argc; n++)
+		if (*argv[n] != '-') {
+			device = argv[n];
+			break;
+		}
+
+	if (!device) {
+		usage();
+		return(1);
+	}
+
+	samples  = ((str = UTL_TSTOPT("n=")) ? atoi(str) : 50);
+	modes    = ((str = UTL_TSTOPT("m=")) ? atoi(str) : (MODE_POLL|MODE_IRQ));
+	range    = ((str = UTL_TSTOPT("r=")) ? atoi(str) : M76_RANGE_DC_V2);
+	blkRange = ((str = UTL_TSTOPT("b=")) ? atoi(str) : M76_RANGE_R2_1);
+	caliRange= ((str = UTL_TSTOPT("k=")) ? atoi(str) : M76_RANGE_DC_V2);
+	sTime    = ((str = UTL_TSTOPT("s=")) ? atoi(str) : 0);
+	store    = (UTL_TSTOPT("c") ? 1 : 0);
+
+	nFilters = ParseList((str = UTL_TSTOPT("f=")) ? str : fDefault,
+						 filters, MAX_LIST);
+	nRanges  = ParseList((str = UTL_TSTOPT("x=")) ? str : xDefault,
+						 ranges, MAX_LIST);
+
+	/* check parameters */
+	if ((samples < 1) || (samples > MAX_SAMPLES))  {
+		printf("wrong number of samples\n");
+		return(1);
+	}
+	if ((modes < 1) || (modes > (MODE_POLL|MODE_IRQ)))  {
+		printf("wrong mode\n");
+		return(1);
+	}
+	if ((range > M76_RANGE_AC_A2) || (blkRange > M76_RANGE_R4_4) ||
+		((blkRange != 0) && (blkRange < M76_RANGE_R2_0)) ||
+		(caliRange > M76_RANGE_R4_4))  {
+		printf("wrong range\n");
+		return(1);
+	}
+	for (i=0; i<nRanges; i++)
+		if (ranges[i] > M76_RANGE_R4_4)  {
+			printf("wrong range\n");
+			return(1);
+		}
+	if ((nRanges == 1) && (ranges[0] == 0))
+		nRanges = 0;
+
+	lat = malloc(sizeof(double) * samples);
+	if (lat == NULL)  {
+		printf("Insufficient memory available\n");
+		return(1);
+	}
+
+	printf("# m76_bench device=%s timer_res_us=%g\n", device,
+#ifdef M76_SIM
+		   0.001
+#else
+		   (double)UOS_MsecTimerResolution() * 1000.0
+#endif
+		   );
+
+	/*--------------------+
+    |  open path (init)   |
+    +--------------------*/
+	t0 = TimeUs();
+	if ((path = M_open(device)) < 0) {
+		PrintMdisError("open");
+		free(lat);
+		return(1);
+	}
+	printf("init open_us=%.0f\n", TimeUs() - t0);
+
+	/*--------------------+
+    |  config             |
+    +--------------------*/
+	if ((M_setstat(path, M_MK_CH_CURRENT, 0) < 0) ||
+		(M_getstat(path, M76_RANGE, (int32*)&oldRange) < 0) ||
+		(M_getstat(path, M76_FILTER, (int32*)&oldFilter) < 0)) {
+		PrintMdisError("config");
+		error = 1;
+		goto abort;
+	}
+	if (sTime && (M_setstat(path, M76_SETTLE, sTime) < 0))  {
+		PrintMdisError("setstat M76_SETTLE");
+		error = 1;
+		goto abort;
+	}
+
+	/*--------------------+
+    |  read               |
+    +--------------------*/
+	for (mode=MODE_POLL; mode<=MODE_IRQ; mode<<=1)  {
+		if (!(modes & mode))
+			continue;
+		for (i=0; i<nFilters; i++)
+			error |= BenchRead(path, mode, filters[i], range, samples, lat);
+		if (blkRange)
+			error |= BenchBlock(path, mode, blkRange, samples, lat);
+	}
+	M_setstat(path, M_MK_IRQ_ENABLE, 0);
+	M_setstat(path, M76_FILTER, oldFilter);
+
+	/*--------------------+
+    |  range switch       |
+    +--------------------*/
+	if (nRanges > 1)
+		error |= BenchSwitch(path, ranges, nRanges);
+
+	/*--------------------+
+    |  calibration        |
+    +--------------------*/
+	if (caliRange >= 0)
+		error |= BenchCali(path, caliRange);
+	if (store)
+		error |= BenchStore(path);
+
+	M_setstat(path, M76_RANGE, oldRange);
+
+	/*--------------------+
+    |  cleanup            |
+    +--------------------*/
+	abort:
+	free(lat);
+	if (M_close(path) < 0)  {
+		PrintMdisError("close");
+		error = 1;
+	}
+	return(error);
+}
+
+/********************************* BenchRead ********************************
+ *
+ *  Description: Measure M_read throughput and latency.
+ *               The first read after the filter change is not counted.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: path		path number
+ *               mode		MODE_POLL or MODE_IRQ
+ *               filter		filter value
+ *               range		measurement range
+ *               n			number of samples
+ *               lat		buffer for n latencies
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 BenchRead(MDIS_PATH path, u_int32 mode, u_int32 filter,
+					   u_int32 range, u_int32 n, double *lat)
+{
+	u_int32 i;
+	int32 value;
+	double t0, t1, tStart;
+
+	if ((M_setstat(path, M_MK_IRQ_ENABLE, mode == MODE_IRQ) < 0) ||
+		(M_setstat(path, M76_RANGE, range) < 0) ||
+		(M_setstat(path, M76_FILTER, filter) < 0) ||
+		(M_read(path, &value) < 0))  {
+		printf("error op=read mode=%s filter=%u msg=\"%s\"\n",
+			   G_modeStr[mode], (unsigned int)filter,
+			   M_errstring(UOS_ErrnoGet()));
+		return(1);
+	}
+
+	tStart = t1 = TimeUs();
+	for (i=0; i<n; i++)  {
+		t0 = t1;
+		if (M_read(path, &value) < 0)  {
+			printf("error op=read mode=%s filter=%u msg=\"%s\"\n",
+				   G_modeStr[mode], (unsigned int)filter,
+				   M_errstring(UOS_ErrnoGet()));
+			return(1);
+		}
+		t1 = TimeUs();
+		lat[i] = t1 - t0;
+	}
+
+	printf("read mode=%s filter=%u range=%u n=%u ", G_modeStr[mode],
+		   (unsigned int)filter, (unsigned int)range, (unsigned int)n);
+	PrintLatency(lat, n, t1 - tStart);
+	return(0);
+}
+
+/********************************* BenchBlock *******************************
+ *
+ *  Description: Measure M_getblock (resistance) throughput and latency.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: path		path number
+ *               mode		MODE_POLL or MODE_IRQ
+ *               range		resistance range
+ *               n			number of samples
+ *               lat		buffer for n latencies
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 BenchBlock(MDIS_PATH path, u_int32 mode, u_int32 range,
+						u_int32 n, double *lat)
+{
+	u_int32 i, rVal[2];
+	double t0, t1, tStart;
+
+	if ((M_setstat(path, M_MK_IRQ_ENABLE, mode == MODE_IRQ) < 0) ||
+		(M_setstat(path, M76_RANGE, range) < 0))  {
+		printf("error op=block mode=%s msg=\"%s\"\n", G_modeStr[mode],
+			   M_errstring(UOS_ErrnoGet()));
+		return(1);
+	}
+
+	tStart = t1 = TimeUs();
+	for (i=0; i<n; i++)  {
+		t0 = t1;
+		if (M_getblock(path, (u_int8*)rVal, sizeof(rVal)) < 0)  {
+			printf("error op=block mode=%s msg=\"%s\"\n", G_modeStr[mode],
+				   M_errstring(UOS_ErrnoGet()));
+			return(1);
+		}
+		t1 = TimeUs();
+		lat[i] = t1 - t0;
+	}
+
+	printf("block mode=%s range=%u n=%u ", G_modeStr[mode],
+		   (unsigned int)range, (unsigned int)n);
+	PrintLatency(lat, n, t1 - tStart);
+	return(0);
+}
+
+/********************************* BenchSwitch ******************************
+ *
+ *  Description: Measure range switch time for each transition pair.
+ *               set_us:   M76_RANGE setstat
+ *               first_us: M76_RANGE setstat and first valid sample
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: path		path number
+ *               ranges		ranges
+ *               nRanges	number of ranges
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 BenchSwitch(MDIS_PATH path, u_int32 *ranges, int32 nRanges)
+{
+	int32 from, to, value;
+	u_int32 rVal[2];
+	double t0, t1, t2;
+
+	for (from=0; from<nRanges; from++)  {
+		for (to=0; to<nRanges; to++)  {
+			if (ranges[to] == ranges[from])
+				continue;
+
+			if (M_setstat(path, M76_RANGE, ranges[from]) < 0)
+				goto error;
+
+			t0 = TimeUs();
+			if (M_setstat(path, M76_RANGE, ranges[to]) < 0)
+				goto error;
+			t1 = TimeUs();
+			if (ranges[to] < M76_RANGE_R2_0)  {
+				if (M_read(path, &value) < 0)
+					goto error;
+			}
+			else  {
+				if (M_getblock(path, (u_int8*)rVal, sizeof(rVal)) < 0)
+					goto error;
+			}
+			t2 = TimeUs();
+
+			printf("switch from=%u to=%u set_us=%.0f first_us=%.0f\n",
+				   (unsigned int)ranges[from], (unsigned int)ranges[to],
+				   t1 - t0, t2 - t0);
+		}
+	}
+	return(0);
+
+error:
+	printf("error op=switch from=%u to=%u msg=\"%s\"\n",
+		   (unsigned int)ranges[from], (unsigned int)ranges[to],
+		   M_errstring(UOS_ErrnoGet()));
+	return(1);
+}
+
+/********************************* BenchCali ********************************
+ *
+ *  Description: Measure M76_CALI for each calibration kind of a range.
+ *               The calibration memory is restored afterwards.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: path		path number
+ *               range		measurement range
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 BenchCali(MDIS_PATH path, u_int32 range)
+{
+	u_int8 img[M76_CALI_BLOB_SIZE];
+	M_SG_BLOCK blk;
+	int32 kind, first, last, value, error=0;
+	double t0;
+
+	blk.size = sizeof(img);
+	blk.data = (void*)img;
+	if ((M_setstat(path, M76_RANGE, range) < 0) ||
+		(M_getstat(path, M76_BLK_CALI_BLOB, (int32*)&blk) < 0))  {
+		printf("error op=cali msg=\"%s\"\n", M_errstring(UOS_ErrnoGet()));
+		return(1);
+	}
+
+	first = (range < M76_RANGE_R2_0) ? 0 : 2;
+	last  = (range < M76_RANGE_R2_0) ? 1 : 5;
+	for (kind=first; kind<=last; kind++)  {
+		value = kind;
+		t0 = TimeUs();
+		if (M_getstat(path, M76_CALI, &value) < 0)  {
+			printf("error op=cali range=%u kind=%d msg=\"%s\"\n",
+				   (unsigned int)range, (int)kind,
+				   M_errstring(UOS_ErrnoGet()));
+			error = 1;
+			break;
+		}
+		printf("cali range=%u kind=%d us=%.0f\n", (unsigned int)range,
+			   (int)kind, TimeUs() - t0);
+	}
+
+	/* discard detected values */
+	blk.size = sizeof(img);
+	if (M_setstat(path, M76_BLK_CALI_BLOB, (INT32_OR_64)&blk) < 0)  {
+		printf("error op=cali_restore msg=\"%s\"\n",
+			   M_errstring(UOS_ErrnoGet()));
+		error = 1;
+	}
+	return(error);
+}
+
+/********************************* BenchStore *******************************
+ *
+ *  Description: Measure M76_STORE_CALI (write calibration memory to
+ *               user EEPROM).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: path		path number
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 BenchStore(MDIS_PATH path)
+{
+	double t0;
+
+	t0 = TimeUs();
+	if (M_setstat(path, M76_STORE_CALI, STORE_KEY) < 0)  {
+		printf("error op=store msg=\"%s\"\n", M_errstring(UOS_ErrnoGet()));
+		return(1);
+	}
+	printf("store us=%.0f\n", TimeUs() - t0);
+	return(0);
+}
+
+/********************************* PrintLatency *****************************
+ *
+ *  Description: Print throughput and latency percentiles (sorts lat[]).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: lat		latencies [usec]
+ *               n			number of latencies
+ *               total		total time [usec]
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PrintLatency(double *lat, u_int32 n, double total)
+{
+	qsort(lat, n, sizeof(double), CmpDouble);
+
+	printf("sps=%.3f min_us=%.0f p50_us=%.0f p90_us=%.0f p99_us=%.0f "
+		   "max_us=%.0f\n",
+		   total > 0.0 ? (double)n * 1e6 / total : 0.0,
+		   lat[0], lat[(n-1)*50/100], lat[(n-1)*90/100], lat[(n-1)*99/100],
+		   lat[n-1]);
+}
+
+/********************************* CmpDouble ********************************
+ *
+ *  Description: qsort compare function
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: a,b		values
+ *  Output.....: return	    <0, 0, >0
+ *  Globals....: -
+ ****************************************************************************/
+static int CmpDouble(const void *a, const void *b)
+{
+	double d = *(const double*)a - *(const double*)b;
+
+	return( d < 0.0 ? -1 : (d > 0.0 ? 1 : 0) );
+}
+
+/********************************* ParseList ********************************
+ *
+ *  Description: Parse comma separated list of numbers
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: str		list
+ *               max		maximum number of entries
+ *  Output.....: list		numbers
+ *               return	    number of entries
+ *  Globals....: -
+ ****************************************************************************/
+static int32 ParseList(char *str, u_int32 *list, int32 max)
+{
+	int32 n = 0;
+	char *end;
+
+	while (*str && (n < max))  {
+		list[n++] = (u_int32)strtoul(str, &end, 0);
+		if (end == str)
+			break;
+		str = end;
+		if (*str == ',')
+			str++;
+	}
+	return(n);
+}
+
+/********************************* TimeUs ***********************************
+ *
+ *  Description: Get current time
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return	    time [usec]
+ *  Globals....: -
+ ****************************************************************************/
+static double TimeUs(void)
+{
+#ifdef M76_SIM
+	return( (double)SIM_TimeNs() / 1000.0 );
+#else
+	return( (double)UOS_MsecTimerGet() * 1000.0 );
+#endif
+}
+
+/********************************* PrintMdisError ***************************
+ *
+ *  Description: Print MDIS error message
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: info	info string
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PrintMdisError(char *info)
+{
+	printf("error op=%s msg=\"%s\"\n", info, M_errstring(UOS_ErrnoGet()));
+}
@@ -0,0 +1,23 @@
+#***************************  M a k e f i l e  *******************************
+#
+#    Description: Makefile definitions for M76 benchmark tool
+#
+#-----------------------------------------------------------------------------
+#   (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+#*****************************************************************************
+
+MAK_NAME=m76_bench
+
+MAK_LIBS=$(LIB_PREFIX)$(MEN_LIB_DIR)/mdis_api$(LIB_SUFFIX)	\
+         $(LIB_PREFIX)$(MEN_LIB_DIR)/usr_oss$(LIB_SUFFIX)	\
+         $(LIB_PREFIX)$(MEN_LIB_DIR)/usr_utl$(LIB_SUFFIX)	\
+
+MAK_INCL=$(MEN_INC_DIR)/m76_drv.h	\
+         $(MEN_INC_DIR)/men_typs.h	\
+         $(MEN_INC_DIR)/mdis_api.h	\
+         $(MEN_INC_DIR)/usr_oss.h	\
+         $(MEN_INC_DIR)/usr_utl.h	\
+
+MAK_INP1=m76_bench$(INP_SUFFIX)
+
+MAK_INP=$(MAK_INP1)
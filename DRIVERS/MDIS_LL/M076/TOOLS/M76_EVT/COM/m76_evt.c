@@ -0,0 +1,356 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                     M76_EVT                        ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *  Description: Read and decode the event trace of the M76 driver
+ *               (M76_BLK_EVT)
+ *
+ *               The event log can be saved to a file (-o=) on the target
+ *               and decoded later on a host (-i=). The file contains the
+ *               M76_EVT_LOG structure in the byte order of the target.
+ *
+ *               Events are printed one per line:
+ *                 <seq> <time_ms> <delta_ms> <event> <arg0> <arg1>
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * (c) Copyright 2026 by MEN Mikro Elektronik GmbH, Nuremberg, Germany
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <MEN/men_typs.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/mdis_api.h>
+#include <MEN/m76_drv.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define LOG_SIZE	M76_EVT_LOG_SIZE(M76_EVT_MAX)
+
+/*--------------------------------------+
+|   TYPDEFS                             |
++--------------------------------------*/
+/* none */
+
+/*--------------------------------------+
+|   EXTERNALS                           |
++--------------------------------------*/
+/* none */
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static const char *G_evName[] = {
+	"none", "irq", "start", "sample", "sem_tout", "poll_tout", "range",
+	"settled", "config", "com", "ee_read", "ee_write", "ee_err",
+	"job_start", "job_end", "trigger", "alarm", "adapt", "zcal"
+};
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void usage(void);
+static void PrintMdisError(char *info);
+static int32 ReadDev(char *device, u_int32 reads, int32 evtOn,
+					 u_int32 clear, M76_EVT_LOG *log);
+static int32 ReadFile(char *name, M76_EVT_LOG *log);
+static int32 WriteFile(char *name, M76_EVT_LOG *log);
+static void PrintLog(M76_EVT_LOG *log);
+
+/********************************* usage ************************************
+ *
+ *  Description: Print program usage
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void usage(void)
+{
+	printf("Usage: m76_evt [<opts>] <device> [<opts>]\n");
+	printf("       m76_evt -i=<file>\n");
+	printf("Function: Read and decode the event trace of the M76 driver\n");
+	printf("Options:\n");
+	printf("  device       device name....................... [none]\n");
+	printf("  -r=<num>     perform <num> M_read before ...... [0]\n");
+	printf("  -e=<0|1>     disable/enable event trace ....... [unchanged]\n");
+	printf("  -c           clear event trace after read ..... [no]\n");
+	printf("  -o=<file>    save event log to file ........... [no]\n");
+	printf("  -i=<file>    decode saved event log, no device\n");
+	printf("\n");
+	printf("Output: <seq> <time_ms> <delta_ms> <event> <arg0> <arg1>\n");
+	printf("\n");
+	printf("(c) 2026 by MEN Mikro Elektronik GmbH\n\n");
+}
+
+/********************************* main *************************************
+ *
+ *  Description: Program main function
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: argc,argv	argument counter, data ..
+ *  Output.....: return	    success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	M76_EVT_LOG *log;
+	int32	n, evtOn, error;
+	u_int32 reads, clear;
+	char	*device, *str, *errstr, buf[256];
+	char	inFile[256], outFile[256];
+
+	/*--------------------+
+    |  check arguments    |
+    +--------------------*/
+	if ((errstr = UTL_ILLIOPT("r=e=co=i=?", buf))) {	/* check args */
+		printf("*** %s\n", errstr);
+		return(1);
+	}
+
+	if (UTL_TSTOPT("?")) {						/* help requested ? */
+		usage();
+		return(1);
+	}
+
+	/*--------------------+
+    |  get arguments      |
+    +--------------------*/
+	for (device=NULL, n=1; n<argc; n++)
+		if (*argv[n] != '-') {
+			device = argv[n];
+			break;
+		}
+
+	/* UTL_TSTOPT returns buf, copy file names */
+	*inFile = *outFile = '\0';
+	if ((str = UTL_TSTOPT("i=")))
+		strncpy(inFile, str, sizeof(inFile)-1);
+	if ((str = UTL_TSTOPT("o=")))
+		strncpy(outFile, str, sizeof(outFile)-1);
+	inFile[sizeof(inFile)-1] = outFile[sizeof(outFile)-1] = '\0';
+
+	reads   = ((str = UTL_TSTOPT("r=")) ? atoi(str) : 0);
+	evtOn   = ((str = UTL_TSTOPT("e=")) ? atoi(str) : -1);
+	clear   = (UTL_TSTOPT("c") ? 1 : 0);
+
+	if (!device && !*inFile) {
+		usage();
+		return(1);
+	}
+
+	if ((log = (M76_EVT_LOG*)malloc(LOG_SIZE)) == NULL)  {
+		printf("*** can't alloc %d bytes\n", (int)LOG_SIZE);
+		return(1);
+	}
+
+	/*--------------------+
+    |  get event log      |
+    +--------------------*/
+	if (*inFile)
+		error = ReadFile(inFile, log);
+	else
+		error = ReadDev(device, reads, evtOn, clear, log);
+
+	if (!error && *outFile)
+		error = WriteFile(outFile, log);
+
+	if (!error)
+		PrintLog(log);
+
+	free(log);
+	return(error ? 1 : 0);
+}
+
+/********************************* ReadDev **********************************
+ *
+ *  Description: Get event log from device
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: device	device name
+ *               reads	number of M_read before
+ *               evtOn	event trace on/off, -1=unchanged
+ *               clear	clear event trace after read
+ *  Output.....: log	event log (M76_EVT_MAX entries)
+ *               return	success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 ReadDev(
+	char *device,
+	u_int32 reads,
+	int32 evtOn,
+	u_int32 clear,
+	M76_EVT_LOG *log)
+{
+	MDIS_PATH	path;
+	M_SG_BLOCK	blk;
+	int32		value, error=0;
+	u_int32		i;
+
+	if ((path = M_open(device)) < 0) {
+		PrintMdisError("open");
+		return(1);
+	}
+
+	if ((evtOn >= 0) && (M_setstat(path, M76_EVT_ON, evtOn) < 0))  {
+		PrintMdisError("setstat M76_EVT_ON");
+		error = 1;
+		goto abort;
+	}
+
+	for (i=0; i<reads; i++)  {
+		if (M_read(path, &value) < 0)  {
+			PrintMdisError("read");
+			break;
+		}
+	}
+
+	blk.size = LOG_SIZE;
+	blk.data = (void*)log;
+	if (M_getstat(path, M76_BLK_EVT, (int32*)&blk) < 0)  {
+		PrintMdisError("getstat M76_BLK_EVT");
+		error = 1;
+		goto abort;
+	}
+
+	if (clear && (M_setstat(path, M76_EVT_CLEAR, 0) < 0))  {
+		PrintMdisError("setstat M76_EVT_CLEAR");
+		error = 1;
+	}
+
+abort:
+	if (M_close(path) < 0)
+		PrintMdisError("close");
+
+	return(error);
+}
+
+/********************************* ReadFile *********************************
+ *
+ *  Description: Load event log from file
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: name	file name
+ *  Output.....: log	event log (M76_EVT_MAX entries)
+ *               return	success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 ReadFile(char *name, M76_EVT_LOG *log)
+{
+	FILE	*fp;
+	size_t	len;
+
+	if ((fp = fopen(name, "rb")) == NULL)  {
+		printf("*** can't open %s\n", name);
+		return(1);
+	}
+	len = fread(log, 1, LOG_SIZE, fp);
+	fclose(fp);
+
+	if ((len < sizeof(M76_EVT_LOG)) || (log->num > M76_EVT_MAX) ||
+		(len < M76_EVT_LOG_SIZE(log->num ? log->num : 1)))  {
+		printf("*** %s: no M76 event log\n", name);
+		return(1);
+	}
+	return(0);
+}
+
+/********************************* WriteFile ********************************
+ *
+ *  Description: Save event log to file
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: name	file name
+ *               log	event log
+ *  Output.....: return	success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 WriteFile(char *name, M76_EVT_LOG *log)
+{
+	FILE	*fp;
+	size_t	len = M76_EVT_LOG_SIZE(log->num ? log->num : 1);
+
+	if ((fp = fopen(name, "wb")) == NULL)  {
+		printf("*** can't create %s\n", name);
+		return(1);
+	}
+	if (fwrite(log, 1, len, fp) != len)  {
+		printf("*** can't write %s\n", name);
+		fclose(fp);
+		return(1);
+	}
+	fclose(fp);
+	return(0);
+}
+
+/********************************* PrintLog *********************************
+ *
+ *  Description: Print decoded event log
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: log	event log
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PrintLog(M76_EVT_LOG *log)
+{
+	M76_EVT	*e;
+	double	tick;
+	u_int32 i, seq;
+
+	tick = log->tickRate ? 1000.0 / log->tickRate : 0.0;
+	seq  = log->total - log->num;
+
+	printf("# total=%u num=%u lost=%u tick_ms=%g\n",
+		   (unsigned)log->total, (unsigned)log->num, (unsigned)seq, tick);
+
+	for (i=0; i<log->num; i++)  {
+		e = &log->evt[i];
+
+		printf("%6u %10.3f %8.3f ", (unsigned)(seq + i),
+			   (e->time - log->evt[0].time) * tick,
+			   i ? (u_int32)(e->time - log->evt[i-1].time) * tick : 0.0);
+
+		if (e->id < sizeof(G_evName)/sizeof(*G_evName))
+			printf("%-9s ", G_evName[e->id]);
+		else
+			printf("ev_%-6u ", (unsigned)e->id);
+
+		switch (e->id)  {
+		case M76_EV_RANGE:
+		case M76_EV_SETTLED:
+		case M76_EV_POLL_TOUT:
+		case M76_EV_JOB_START:
+		case M76_EV_JOB_END:
+		case M76_EV_ADAPT:
+		case M76_EV_ZCAL:
+			printf("%d %d\n", (int)e->arg[0], (int)e->arg[1]);
+			break;
+		default:
+			printf("0x%x 0x%x\n", (unsigned)e->arg[0], (unsigned)e->arg[1]);
+		}
+	}
+}
+
+/********************************* PrintMdisError ***************************
+ *
+ *  Description: Print MDIS error message
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: info	info string
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PrintMdisError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
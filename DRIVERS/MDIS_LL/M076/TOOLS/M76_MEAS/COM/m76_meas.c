@@ -162,6 +162,7 @@ page2:
 	printf("          values until key is pressed.                      \n");
 	printf("        - shows min Value.                                  \n");
 	printf("        - shows max Value.                                  \n");
+	printf("        - shows driver statistics of raw codes (U/I ranges) \n");
 	printf("        - errors occuring after path to device is opened    \n");
 	printf("          must confirmed.                                   \n");
 	printf("  these options are active only when option -t is given:    \n");              
@@ -371,6 +372,16 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	/* driver statistics of raw codes (M_read only) */
+	if (test && (range < M76_RANGE_R2_0))  {
+		if ((M_setstat(path, M76_STAT_CLEAR, 0) < 0) ||
+			(M_setstat(path, M76_STAT_ON, 1) < 0))  {
+			PrintMdisError("setstat M76_STAT_ON");
+			error = 1;
+			goto abort;
+		}
+	}
+
 	/*--------------------+
     |  read               |
     +--------------------*/
@@ -602,6 +613,31 @@ int main(int argc, char *argv[])
 		printf("| value > average: %u\n", (unsigned int)maxCnt);
 		printf("+------------------------------------------------------------\n");
 
+		if (range < M76_RANGE_R2_0)  {
+			M76_STAT st;
+			M_SG_BLOCK blk;
+
+			blk.size = sizeof(st);
+			blk.data = (void*)&st;
+			if (M_getstat(path, M76_BLK_STAT, (int32*)&blk) < 0)  {
+				PrintMdisError("getstat M76_BLK_STAT");
+				error = 1;
+			}
+			else  {
+				printf("| driver statistics (raw codes):\n");
+				printf("| number of conversions: %u\n", (unsigned int)st.cur.count);
+				printf("| average = %.3f\n",
+					   (double)st.cur.mean / (1 << M76_STAT_Q));
+				printf("| min = 0x%06x  max = 0x%06x\n",
+					   (unsigned int)st.cur.min, (unsigned int)st.cur.max);
+				printf("| variance = %.3f\n", st.cur.count > 1 ?
+					   (double)st.cur.m2 / (1 << M76_STAT_Q) / (st.cur.count-1)
+					   : 0.0);
+				printf("+------------------------------------------------------------\n");
+			}
+			M_setstat(path, M76_STAT_ON, 0);
+		}
+
 		/* error check */
 		if ( (min < minLim) || (max > maxLim) )  {
 			error = 1;
@@ -51,6 +51,211 @@ typedef struct {
 	u_int32		value;      /* value */
 } M76_CALI_VAL;
 
+/* calibration job (M76_BLK_CALI_JOB) */
+typedef struct {
+	u_int32		range;		/* M76_RANGE_xxx */
+	u_int32		kind;		/* kind of value 0..5 (see M76_CALI) */
+	int32		value;		/* out: detected calibration value */
+	int32		error;		/* out: error code of step */
+} M76_CALI_STEP;
+
+typedef struct {
+	u_int32		flags;		/* M76_CALI_JOB_xxx */
+	u_int32		nSteps;		/* number of steps (1..M76_CALI_JOB_MAX) */
+	u_int32		nFailed;	/* out: number of failed steps */
+	u_int32		stored;		/* out: values stored in user EEPROM */
+	M76_CALI_STEP	step[1];	/* nSteps steps */
+} M76_CALI_JOB;
+
+/* size of M76_CALI_JOB with n steps [bytes] */
+#define M76_CALI_JOB_SIZE(n)	(sizeof(M76_CALI_JOB)+((n)-1)*sizeof(M76_CALI_STEP))
+#define M76_CALI_JOB_MAX		156		/* 26 ranges * 6 kinds */
+#define M76_CALI_JOB_STORE		0x1		/* store in user EEPROM if all ok */
+
+/* state of asynchronous job (M76_BLK_JOB_STAT) */
+typedef struct {
+	u_int32		state;		/* M76_JOB_xxx */
+	u_int32		type;		/* M76_JOBTYPE_xxx */
+	u_int32		progress;	/* 0..100 [%] */
+	int32		error;		/* error code (M76_JOB_ERROR) */
+	int32		value;		/* detected calibration value (M76_JOBTYPE_CALI) */
+} M76_JOB_STAT;
+
+/* bus access trace (M76_BLK_TRC, driver built with switch M76_TRACE) */
+#define M76_TRC_LOG_SIZE	256		/* entries of register access log */
+
+/* scope of bus access trace (M76_TRC.cnt[], M76_TRC_ACC.scope) */
+/* entry points count all accesses of the call incl. helpers, */
+/* helpers only their own accesses (not those of nested helpers) */
+#define M76_TRC_SC_NONE		0
+#define M76_TRC_SC_INIT		1	/* M76_Init */
+#define M76_TRC_SC_EXIT		2	/* M76_Exit */
+#define M76_TRC_SC_READ		3	/* M76_Read */
+#define M76_TRC_SC_WRITE	4	/* M76_Write */
+#define M76_TRC_SC_BLKREAD	5	/* M76_BlockRead */
+#define M76_TRC_SC_BLKWRITE	6	/* M76_BlockWrite */
+#define M76_TRC_SC_SETSTAT	7	/* M76_SetStat */
+#define M76_TRC_SC_GETSTAT	8	/* M76_GetStat */
+#define M76_TRC_SC_IRQ		9	/* M76_Irq */
+#define M76_TRC_SC_ALARM	10	/* alarm (asynchronous job, paced sampling) */
+#define M76_TRC_SC_SETRANGE	11	/* SetRange */
+#define M76_TRC_SC_CONFIG	12	/* WriteConfigReg */
+#define M76_TRC_SC_MODE		13	/* WriteModeReg */
+#define M76_TRC_SC_FILTER	14	/* WriteFilterReg */
+#define M76_TRC_SC_CALIREG	15	/* WriteCaliReg */
+#define M76_TRC_SC_CALCONV	16	/* CalibConv */
+#define M76_TRC_SC_LOADCALI	17	/* LoadCaliVals */
+#define M76_TRC_SC_RDPROM	18	/* ReadCaliProm */
+#define M76_TRC_SC_WRPROM	19	/* WriteCaliProm */
+#define M76_TRC_SC_UEEWRITE	20	/* UeeWrite */
+#define M76_TRC_SC_DATAREG	21	/* ReadDataReg */
+#define M76_TRC_SC_JOBCALI	22	/* JobCaliStep */
+#define M76_TRC_SC_JOBSTORE	23	/* JobStoreStep */
+#define M76_TRC_SCOPES		24	/* number of scopes */
+
+typedef struct {
+	u_int32		calls;		/* calls of entry point/helper */
+	u_int32		reads;		/* MREAD_D16 accesses */
+	u_int32		writes;		/* MWRITE_D16 accesses */
+	u_int32		delays;		/* OSS_Delay/OSS_MikroDelay calls */
+	u_int32		delayUs;	/* requested delay time [usec] */
+} M76_TRC_CNT;
+
+typedef struct {
+	u_int8		scope;		/* M76_TRC_SC_xxx */
+	u_int8		op;			/* M76_TRC_OP_xxx */
+	u_int16		offs;		/* register offset */
+	u_int32		val;		/* value read/written, delay [msec/usec] */
+} M76_TRC_ACC;
+
+typedef struct m76_trc {
+	u_int32		logOn;		/* register access log enabled */
+	u_int32		logCnt;		/* logged accesses, next entry at */
+							/* log[logCnt % M76_TRC_LOG_SIZE] */
+	M76_TRC_CNT	cnt[M76_TRC_SCOPES];	/* counters per M76_TRC_SC_xxx */
+	M76_TRC_ACC	log[M76_TRC_LOG_SIZE];	/* register access log (ring) */
+} M76_TRC;
+
+/* event trace (M76_BLK_EVT) */
+#define M76_EVT_MAX			128		/* entries of driver event ring */
+
+typedef struct {
+	u_int32		time;		/* timestamp [ticks, see M76_EVT_LOG.tickRate] */
+	u_int32		id;			/* M76_EV_xxx */
+	u_int32		arg[2];		/* arguments, see M76_EV_xxx */
+} M76_EVT;
+
+typedef struct {
+	u_int32		total;		/* events since init/M76_EVT_CLEAR */
+	u_int32		tickRate;	/* timestamp ticks per second */
+	u_int32		num;		/* out: entries in evt[], oldest first */
+	u_int32		reserved;
+	M76_EVT		evt[1];		/* num events */
+} M76_EVT_LOG;
+
+/* size of M76_EVT_LOG with n events [bytes] */
+#define M76_EVT_LOG_SIZE(n)	(sizeof(M76_EVT_LOG)+((n)-1)*sizeof(M76_EVT))
+
+/* acquisition statistics (M76_BLK_ACQ_STAT) */
+/* histogram bin 0: t=0, bin n: 2^(n-1) <= t < 2^n ticks (last bin: all above) */
+#define M76_ACQ_BINS		24		/* bins of log2 histograms */
+
+typedef struct {
+	u_int32		tickRate;	/* histogram ticks per second */
+	u_int32		reads;		/* conversions read */
+	u_int32		semTout;	/* interrupt wait errors (timeouts) */
+	u_int32		pollTout;	/* poll timeouts (ERR_LL_DEV_NOTRDY) */
+	u_int32		irqs;		/* interrupts of the device */
+	u_int32		settles;	/* settle delays */
+	u_int32		settleMs;	/* total settle time [ms] */
+	u_int32		reserved;
+	u_int32		convLat[M76_ACQ_BINS];	/* transfer armed (TR24R) to data read */
+	u_int32		irqWake[M76_ACQ_BINS];	/* interrupt to reader woken */
+	u_int32		settle[M76_ACQ_BINS];	/* settle delay */
+} M76_ACQ_STAT;
+
+/* streaming statistics of raw codes (M76_BLK_STAT) */
+/* variance = m2 / (count-1) / 2^M76_STAT_Q */
+#define M76_STAT_Q			8		/* fraction bits of mean and m2 */
+#define M76_STAT_WIN_MAX	1024	/* max. M76_STAT_WIN, m2 can't overflow */
+
+typedef struct {
+	u_int32		count;		/* conversions */
+	int32		min;		/* min. raw code */
+	int32		max;		/* max. raw code */
+	u_int32		reserved;
+	int64		mean;		/* mean * 2^M76_STAT_Q */
+	u_int64		m2;			/* sum of squared deviations * 2^M76_STAT_Q */
+} M76_STAT_SET;
+
+typedef struct {
+	u_int32		window;		/* window length (0: since clear) */
+	u_int32		windows;	/* completed windows since clear */
+	M76_STAT_SET cur;		/* running window */
+	M76_STAT_SET last;		/* last completed window */
+} M76_STAT;
+
+/* envelope record of M76_BlockRead (M76_ENV_N > 0, U/I ranges) */
+typedef struct {
+	int32		min;		/* min. raw code */
+	int32		max;		/* max. raw code */
+	int32		mean;		/* mean raw code (rounded) */
+	u_int32		count;		/* conversions (M76_ENV_N) */
+} M76_ENV;
+
+/* latest conversion (M76_BLK_LATEST, M76_NBLOCK_LATEST) */
+typedef struct {
+	int32		value;		/* raw code */
+	u_int32		seq;		/* conversions since M76_NBLOCK set */
+	u_int32		age;		/* time since conversion [ms] */
+} M76_LATEST;
+
+/* background zero-scale self-calibration (M76_BLK_ZCAL), ADC zero-scale
+   calibration register values of the current range */
+typedef struct {
+	u_int32		slots;		/* self-calibrations done */
+	u_int32		range;		/* M76_RANGE_xxx */
+	int32		base;		/* first self-calibration after range/filter set */
+	int32		last;		/* latest self-calibration */
+	int32		drift;		/* last - base */
+	int32		stored;		/* zero-scale value of calibration memory */
+	int32		applied;	/* zero-scale value in ADC */
+	u_int32		age;		/* time since latest self-calibration [ms] */
+} M76_ZCAL_INFO;
+
+/* custom range preset (M76_BLK_RANGE_DEF, descriptor RANGE_USER_<n>/xxx) */
+typedef struct {
+	u_int32		range;		/* M76_RANGE_USER(n) */
+	u_int32		config;		/* Config. Reg. value, see hardware manual */
+	u_int16		chan;		/* ADC channel 0..7 (DC: 4, AC: 6) */
+	u_int16		gain;		/* ADC gain code 0..7 (gain 2^code) */
+	u_int16		unipolar;	/* unipolar (1) or bipolar (0) */
+	u_int16		filter;		/* filter word 20..1920 (0=unchanged) */
+	u_int32		settle;		/* settling time [ms] (0=unchanged) */
+	int32		caliZero;	/* zero-scale calibration value */
+	int32		caliFull;	/* full-scale calibration value */
+} M76_RANGE_DEF;
+
+/* record of paced sampling (M76_PACE_PERIOD > 0), read by M76_BlockRead */
+typedef struct {
+	int32		value;		/* raw code */
+	u_int32		seq;		/* alarm period number, from 0 */
+	u_int32		time;		/* time since start [ms] */
+} M76_PACE_REC;
+
+/* trigger record of M76_BlockRead (M76_TRG_MODE != M76_TRG_OFF) */
+typedef struct {
+	u_int32		pre;		/* samples before trigger sample */
+	u_int32		post;		/* samples from trigger sample on */
+	u_int32		time;		/* time of trigger sample [ticks] */
+	u_int32		tickRate;	/* ticks per second */
+	u_int32		waited;		/* conversions before trigger */
+	u_int32		reserved;
+	int32		data[1];	/* pre+post samples (M76_FORMAT), oldest first */
+} M76_TRG_REC;
+
+#define M76_TRG_REC_SIZE(n)	(sizeof(M76_TRG_REC) + ((n)-1)*sizeof(int32))
+
 /*-----------------------------------------+
 |  DEFINES                                 |
 +-----------------------------------------*/
@@ -64,8 +269,190 @@ typedef struct {
 #define M76_CINFO	M_DEV_OF+0x07		/* G  : calibration info of range */
 #define M76_DELMAGIC	M_DEV_OF+0x10		/*   S: delete magic word in uee */
 #define M76_FILTER      M_DEV_OF+0x11		/* G,S: filter Value */
+#define M76_CALI_SRC	M_DEV_OF+0x12		/* G  : source of calibration memory */
+#define M76_CALI_DIRTY	M_DEV_OF+0x13		/* G  : ranges changed, not stored */
+#define M76_ASYNC		M_DEV_OF+0x14		/* G,S: asynchronous M76_CALI/M76_STORE_CALI */
+#define M76_JOB_STATE	M_DEV_OF+0x15		/* G  : state of asynchronous job */
+#define M76_JOB_CANCEL	M_DEV_OF+0x16		/*   S: cancel asynchronous job */
+#define M76_TRC_LOG		M_DEV_OF+0x17		/* G,S: register access log on/off */
+#define M76_TRC_CLEAR	M_DEV_OF+0x18		/*   S: clear trace counters and log */
+#define M76_EVT_ON		M_DEV_OF+0x19		/* G,S: event trace on/off */
+#define M76_EVT_CLEAR	M_DEV_OF+0x1a		/*   S: clear event trace */
+#define M76_ACQ_CLEAR	M_DEV_OF+0x1b		/*   S: clear acquisition statistics */
+#define M76_PFILT		M_DEV_OF+0x1c		/* G,S: post-filter type */
+#define M76_PFILT_N		M_DEV_OF+0x1d		/* G,S: post-filter length/IIR shift */
+#define M76_OVS			M_DEV_OF+0x1e		/* G,S: oversampling 2^k (current range) */
+#define M76_OVS_FRAC	M_DEV_OF+0x1f		/* G,S: fraction bits of M76_Read value */
+#define M76_OVS_RND		M_DEV_OF+0x20		/* G,S: round (1) or truncate (0) */
+#define M76_STAT_ON		M_DEV_OF+0x21		/* G,S: streaming statistics on/off */
+#define M76_STAT_WIN	M_DEV_OF+0x22		/* G,S: statistics window length */
+#define M76_STAT_CLEAR	M_DEV_OF+0x23		/*   S: clear streaming statistics */
+#define M76_ENV_N		M_DEV_OF+0x24		/* G,S: conversions per envelope record */
+#define M76_DB_ABS		M_DEV_OF+0x25		/* G,S: dead-band, absolute [codes] */
+#define M76_DB_REL		M_DEV_OF+0x26		/* G,S: dead-band, relative [ppm] */
+#define M76_DB_HEART	M_DEV_OF+0x27		/* G,S: dead-band heartbeat [ms] */
+#define M76_TRG_MODE	M_DEV_OF+0x28		/* G,S: trigger mode */
+#define M76_TRG_LEVEL	M_DEV_OF+0x29		/* G,S: trigger level/window low */
+#define M76_TRG_LEVEL2	M_DEV_OF+0x2a		/* G,S: trigger window high */
+#define M76_TRG_PRE		M_DEV_OF+0x2b		/* G,S: pre-trigger samples */
+#define M76_TRG_POST	M_DEV_OF+0x2c		/* G,S: post-trigger samples */
+#define M76_TRG_TOUT	M_DEV_OF+0x2d		/* G,S: trigger timeout [ms] */
+#define M76_ALM_ON		M_DEV_OF+0x2e		/* G,S: limit alarms on/off */
+#define M76_ALM_HIGH	M_DEV_OF+0x2f		/* G,S: high alarm limit */
+#define M76_ALM_LOW		M_DEV_OF+0x30		/* G,S: low alarm limit */
+#define M76_ALM_HYST	M_DEV_OF+0x31		/* G,S: alarm hysteresis */
+#define M76_ALM_STATE	M_DEV_OF+0x32		/* G,S: alarm state/clear latched */
+#define M76_SIG_SET		M_DEV_OF+0x33		/*   S: install alarm signal */
+#define M76_SIG_CLR		M_DEV_OF+0x34		/*   S: remove alarm signal */
+#define M76_NBLOCK		M_DEV_OF+0x35		/* G,S: non-blocking read mode */
+#define M76_RDY_SIG_SET	M_DEV_OF+0x36		/*   S: install data ready signal */
+#define M76_RDY_SIG_CLR	M_DEV_OF+0x37		/*   S: remove data ready signal */
+#define M76_PACE_PERIOD	M_DEV_OF+0x38		/* G,S: paced sampling period [ms] */
+#define M76_PACE_SIZE	M_DEV_OF+0x39		/* G,S: paced sampling queue size */
+#define M76_PACE_WMARK	M_DEV_OF+0x3a		/* G,S: paced sampling watermark */
+#define M76_PACE_LOST	M_DEV_OF+0x3b		/* G  : records lost (queue full) */
+#define M76_PACE_LATE	M_DEV_OF+0x3c		/* G  : periods without conversion */
+#define M76_FORMAT		M_DEV_OF+0x3d		/* G,S: sample format */
+#define M76_FAST		M_DEV_OF+0x3e		/* G,S: 16-bit fast mode on/off */
+#define M76_PLC			M_DEV_OF+0x3f		/* G,S: mains-synchronous filter preset */
+#define M76_FILT_RATE	M_DEV_OF+0x40		/* G  : conversion rate [mHz] */
+#define M76_FILT_SETTLE	M_DEV_OF+0x41		/* G  : filter settle time [ms] */
+#define M76_ADAPT		M_DEV_OF+0x42		/* G,S: noise-adaptive filter target [LSB] */
+#define M76_ADAPT_NOISE	M_DEV_OF+0x43		/* G  : estimated noise rms [LSB] */
+#define M76_ZCAL		M_DEV_OF+0x44		/* G,S: background zero-scale self-calibration */
+#define M76_ZCAL_PERIOD	M_DEV_OF+0x45		/* G,S: self-calibration period [ms] */
+#define M76_ZCAL_FLAG	M_DEV_OF+0x46		/* G  : last value read after self-calibration */
 /* M76 specific status codes (BLK)	*/			/* S,G: S=setstat, G=getstat */
 #define M76_BLK_CALI		M_DEV_BLK_OF+0x00 	/* S  : write a value to caliVals */
+#define M76_BLK_CALI_BLOB	M_DEV_BLK_OF+0x01 	/* G,S: export/load calibration memory image */
+#define M76_BLK_CALI_JOB	M_DEV_BLK_OF+0x03 	/* G  : calibrate a list of ranges */
+#define M76_BLK_JOB_STAT	M_DEV_BLK_OF+0x04 	/* G  : state of asynchronous job */
+#define M76_BLK_TRC			M_DEV_BLK_OF+0x05 	/* G  : bus access trace (M76_TRC) */
+#define M76_BLK_EVT			M_DEV_BLK_OF+0x06 	/* G  : event trace (M76_EVT_LOG) */
+#define M76_BLK_ACQ_STAT	M_DEV_BLK_OF+0x07 	/* G  : acquisition statistics */
+#define M76_BLK_STAT		M_DEV_BLK_OF+0x08 	/* G  : streaming statistics (M76_STAT) */
+#define M76_BLK_LATEST		M_DEV_BLK_OF+0x09 	/* G  : latest conversion (M76_LATEST) */
+#define M76_BLK_ZCAL		M_DEV_BLK_OF+0x0a 	/* G  : self-calibration offset (M76_ZCAL_INFO) */
+#define M76_BLK_RANGE_DEF	M_DEV_BLK_OF+0x0b 	/* G,S: custom range preset (M76_RANGE_DEF) */
+
+/* calibration memory image (M76_BLK_CALI_BLOB, descriptor key CALI_BLOB) */
+/* header (magic, version, word count), calibration words in user EEPROM */
+/* layout, XORed checksum of calibration words; each word stored MSB first */
+#define M76_CALI_WORDS		144		/* calibration words */
+#define M76_CALI_BLOB_MAGIC	0x4d76	/* "Mv" */
+#define M76_CALI_BLOB_VERSION	1
+#define M76_CALI_BLOB_HDR	3		/* header words */
+#define M76_CALI_BLOB_SIZE	((M76_CALI_BLOB_HDR+M76_CALI_WORDS+1)*2)	/* image size [bytes] */
+
+/* calibration policy (descriptor key CALI_POLICY) */
+#define M76_CALI_POL_EEPROM	0	/* read user EEPROM only */
+#define M76_CALI_POL_BLOB	1	/* use CALI_BLOB, EEPROM as fallback */
+#define M76_CALI_POL_COMPARE	2	/* read both, CALI_BLOB wins on mismatch */
+
+/* state of asynchronous job (M76_JOB_STATE) */
+#define M76_JOB_IDLE		0	/* no job started */
+#define M76_JOB_BUSY		1	/* job running */
+#define M76_JOB_DONE		2	/* job finished successfully */
+#define M76_JOB_ERROR		3	/* job failed */
+#define M76_JOB_CANCELED	4	/* job canceled */
+
+/* operation of register access log (M76_TRC_ACC.op) */
+#define M76_TRC_OP_READ		0	/* MREAD_D16 */
+#define M76_TRC_OP_WRITE	1	/* MWRITE_D16 */
+#define M76_TRC_OP_DELAY	2	/* OSS_Delay, val [msec] */
+#define M76_TRC_OP_UDELAY	3	/* OSS_MikroDelay, val [usec] */
+
+/* event of event trace (M76_EVT.id)                arg[0]          arg[1] */
+#define M76_EV_NONE			0
+#define M76_EV_IRQ			1	/* interrupt		Status Reg.		irq count */
+#define M76_EV_START		2	/* transfer started	command word	Access Reg. */
+#define M76_EV_SAMPLE		3	/* sample ready		Data Reg.		ADC channel */
+#define M76_EV_SEM_TOUT		4	/* irq timeout		error code		ADC register */
+#define M76_EV_POLL_TOUT	5	/* poll timeout		polls			ADC register */
+#define M76_EV_RANGE		6	/* range switch		new range		old range */
+#define M76_EV_SETTLED		7	/* range settled	range			settle time [ms] */
+#define M76_EV_CONFIG		8	/* Config. Reg.		value			- */
+#define M76_EV_COM			9	/* Comm. Reg.		command word	data written */
+#define M76_EV_EE_READ		10	/* user EEPROM read	stored checksum	calc. checksum */
+#define M76_EV_EE_WRITE		11	/* user EEPROM word	index			value */
+#define M76_EV_EE_ERR		12	/* user EEPROM err.	index			error code */
+#define M76_EV_JOB_START	13	/* job started		M76_JOBTYPE_xxx	kind */
+#define M76_EV_JOB_END		14	/* job finished		M76_JOB_xxx		error code */
+#define M76_EV_TRIGGER		15	/* trigger			raw code		conversions */
+#define M76_EV_ALARM		16	/* limit violated	M76_ALM_xxx		raw code */
+#define M76_EV_ADAPT		17	/* filter adapted	filter word		noise rms [LSB] */
+#define M76_EV_ZCAL			18	/* zero self-cal.	cali. value		drift */
+
+/* type of asynchronous job */
+#define M76_JOBTYPE_NONE	0
+#define M76_JOBTYPE_CALI	1	/* M76_CALI */
+#define M76_JOBTYPE_STORE	2	/* M76_STORE_CALI */
+
+/* source of calibration memory (M76_CALI_SRC) */
+#define M76_CALI_SRC_EEPROM	0	/* read from user EEPROM */
+#define M76_CALI_SRC_BLOB	1	/* loaded from calibration image */
+#define M76_CALI_SRC_DIFF	2	/* image used, differs from EEPROM */
+
+/* post-filter of M76_Read (M76_PFILT), applied to (oversampled) samples */
+#define M76_PFILT_NONE		0	/* off */
+#define M76_PFILT_BOX		1	/* moving average of M76_PFILT_N samples */
+#define M76_PFILT_MEDIAN	2	/* median of M76_PFILT_N samples */
+#define M76_PFILT_IIR		3	/* y += (x-y) / 2^M76_PFILT_N */
+#define M76_PFILT_MAX		64	/* max. M76_PFILT_N of BOX/MEDIAN */
+#define M76_PFILT_IIR_MAX	8	/* max. M76_PFILT_N of IIR */
+
+/* oversampling of M76_Read (M76_OVS, M76_OVS_FRAC) */
+#define M76_OVS_MAX			8	/* max. k, 2^k conversions per value */
+#define M76_OVS_FRAC_MAX	7	/* max. fraction bits (24+7 bit value) */
+
+/* trigger of M76_BlockRead (M76_TRG_MODE), levels are raw codes */
+#define M76_TRG_OFF			0	/* off */
+#define M76_TRG_RISING		1	/* x crosses level upwards */
+#define M76_TRG_FALLING		2	/* x crosses level downwards */
+#define M76_TRG_WINDOW		3	/* x < level or x > level2 */
+#define M76_TRG_MAX			65536	/* max. M76_TRG_PRE/M76_TRG_POST */
+
+/* limit alarms (M76_ALM_STATE), limits are raw codes */
+#define M76_ALM_HI			0x01	/* high limit exceeded (latched) */
+#define M76_ALM_LO			0x02	/* low limit exceeded (latched) */
+#define M76_ALM_HI_ACT		0x10	/* high limit exceeded (now) */
+#define M76_ALM_LO_ACT		0x20	/* low limit exceeded (now) */
+
+/* non-blocking read of M76_Read (M76_NBLOCK) */
+#define M76_NBLOCK_OFF		0	/* wait for conversion */
+#define M76_NBLOCK_NEXT		1	/* next conversion, M76_ERR_NODATA until ready */
+#define M76_NBLOCK_LATEST	2	/* latest conversion, converting continuously */
+
+/* paced sampling (M76_PACE_SIZE) */
+#define M76_PACE_MAX		65536	/* max. queue size [records] */
+
+/* sample format (M76_FORMAT) of M76_Read, resistance and trigger samples */
+#define M76_FMT_WORD		0	/* code in 32-bit word, upper byte 0 */
+#define M76_FMT_STATUS		1	/* upper byte: status bits and range */
+#define M76_FMT_PACKED		2	/* 3 bytes per code, MSB first (blocks only) */
+
+/* status of M76_FMT_STATUS word */
+#define M76_FMT_OVER		0x80000000	/* code 0xffffff, 0xffff00 in M76_FAST mode */
+#define M76_FMT_UNDER		0x40000000	/* code 0 (zero/negative full-scale) */
+#define M76_FMT_CALI_BAD	0x20000000	/* calibration checksum invalid */
+#define M76_FMT_RANGE(w)	(((u_int32)(w) >> 24) & 0x1f)	/* M76_RANGE_xxx */
+#define M76_FMT_CODE(w)		((w) & 0x00ffffff)				/* raw code */
+
+/* mains-synchronous filter presets (M76_PLC): mains cycles per conversion,
+   any value 1..M76_PLC_MAX(MAINS_FREQ) is accepted */
+#define M76_PLC_NONE		0	/* filter word not synchronous (M76_FILTER) */
+#define M76_PLC_FAST		1	/* 50/60 Hz rate, settle 60/50 ms */
+#define M76_PLC_MEDIUM		2	/* 25/30 Hz rate, settle 120/100 ms */
+#define M76_PLC_SLOW		5	/* 10/12 Hz rate, settle 300/250 ms */
+#define M76_PLC_MAX(hz)		((hz) / 10)	/* filter word 1920 */
+
+/* background zero-scale self-calibration (M76_ZCAL) */
+#define M76_ZCAL_OFF		0
+#define M76_ZCAL_TRACK		1	/* track offset drift only */
+#define M76_ZCAL_APPLY		2	/* correct zero-scale calibration by drift */
+
+/* non-blocking read: conversion not ready yet (mdis_err.h) */
+#define M76_ERR_NODATA		(ERR_DEV+0x01)
 
 
 /* measurement ranges */
@@ -101,6 +488,9 @@ typedef struct {
 #define M76_RANGE_R4_3		24	/* resistance, 4-wire, 250 kOHM */
 #define M76_RANGE_R4_4		25	/* resistance, 4-wire, 2.5 MOHM */
 
+#define M76_RANGE_USER(n)	(26+(n))	/* custom range preset n (M76_RANGE_DEF) */
+#define M76_RANGE_USER_MAX	6			/* number of custom range presets */
+
 
 #ifndef  M76_VARIANT
 # define M76_VARIANT M76